@@ -0,0 +1,101 @@
+//
+// Created by Sami Dahoux on 2019-01-27.
+//
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <BQueue.h>
+
+#define QUEUE_TEST_COUNT 20000
+
+using namespace std;
+
+TEST(BQueueTest, Bounded) {
+    BQueue<int> queue{3};
+    int value = 0;
+
+    ASSERT_EQ(queue.capacity(), 4);
+    for (int k = 0; k < 4; ++k) {
+        EXPECT_TRUE(queue.tryPush(k));
+    }
+    EXPECT_FALSE(queue.tryPush(value));
+
+    for (int k = 0; k < 4; ++k) {
+        EXPECT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, k);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+
+    BQueue<int> single{1};
+    EXPECT_EQ(single.capacity(), 2);
+}
+
+TEST(BQueueTest, Concurrent) {
+    BQueue<long> queue{16};
+    atomic<long> sum{0};
+    atomic<int> producers{2};
+    vector<thread> pool;
+
+    for (int t = 0; t < 2; ++t) {
+        pool.emplace_back([&queue, &producers, t]() {
+            for (long k = 1; k <= QUEUE_TEST_COUNT; ++k) {
+                long value = (t + 1) * k;
+                while (!queue.tryPush(value)) {
+                    this_thread::yield();
+                }
+            }
+            producers--;
+        });
+        pool.emplace_back([&queue, &producers, &sum]() {
+            long value;
+            bool over = false;
+            while (!over) {
+                // Queue is drained once more after the producers are over
+                over = producers == 0;
+                while (queue.tryPop(value)) {
+                    sum += value;
+                }
+                this_thread::yield();
+            }
+        });
+    }
+    for (auto &thread : pool) {
+        thread.join();
+    }
+
+    EXPECT_EQ(sum, 3L * QUEUE_TEST_COUNT * (QUEUE_TEST_COUNT + 1) / 2);
+}
+
+TEST(BQueueTest, Blocking) {
+    BQueue<long> queue{4};
+    atomic<long> sum{0};
+    atomic<int> producers{2};
+    vector<thread> pool;
+
+    // Consumers sleep on the empty queue and are over once the queue is closed and drained
+    for (int t = 0; t < 2; ++t) {
+        pool.emplace_back([&queue, &sum]() {
+            long value;
+            while (queue.pop(value)) {
+                sum += value;
+            }
+        });
+    }
+    for (int t = 0; t < 2; ++t) {
+        pool.emplace_back([&queue, &producers, t]() {
+            for (long k = 1; k <= QUEUE_TEST_COUNT; ++k) {
+                long value = (t + 1) * k;
+                queue.push(value);
+            }
+            if (--producers == 0)
+                queue.close();
+        });
+    }
+    for (auto &thread : pool) {
+        thread.join();
+    }
+
+    long value;
+    EXPECT_EQ(sum, 3L * QUEUE_TEST_COUNT * (QUEUE_TEST_COUNT + 1) / 2);
+    EXPECT_FALSE(queue.pop(value));
+}
@@ -0,0 +1,105 @@
+//
+// Created by Sami Dahoux on 2019-01-27.
+//
+
+#include <gtest/gtest.h>
+#include <BatchRunner.h>
+
+#define BATCH_TEST_SIZE 8
+#define BATCH_TEST_IMAGES 12
+
+using namespace std;
+
+class BatchRunnerTest : public ::testing::Test {
+
+public:
+
+    // Synthetic images whose pattern depends on the index given by the path
+    static IMatrix decode(const string &path) {
+        size_t k = stoul(path), side = 24 + 2 * k;
+        IMatrix img{mat_pix_t::zeros(side)};
+
+        for (size_t x = 0; x < side; ++x) {
+            for (size_t y = 0; y < side; ++y) {
+                img(x, y) = Pixel((((x + k) / 4) % 2 == 0) ? 255 : 0);
+            }
+        }
+        return img;
+    }
+
+    vector<WClassifier> h{
+            WClassifier(PHaar(0, 0, BATCH_TEST_SIZE, BATCH_TEST_SIZE, PHaar::TwoRectW), 1000.0),
+            WClassifier(PHaar(0, 0, BATCH_TEST_SIZE, BATCH_TEST_SIZE, PHaar::TwoRectH), -1000.0)
+    };
+    Detector detector{h, vec_t{1.0, 1.0}, BATCH_TEST_SIZE};
+};
+
+TEST_F(BatchRunnerTest, Run) {
+    vector<string> paths;
+    vector<vector<Detection> > results(BATCH_TEST_IMAGES);
+    vector<size_t> calls(BATCH_TEST_IMAGES, 0);
+
+    for (size_t k = 0; k < BATCH_TEST_IMAGES; ++k) {
+        paths.push_back(to_string(k));
+    }
+
+    BatchRunner runner{detector, 2, 1, 2, 2};
+    runner.setDecoder(decode);
+
+    auto stages = runner.run(paths, [&](size_t k, const string &path, const vector<Detection> &detections,
+                                        const string &error) {
+        EXPECT_EQ(path, paths[k]);
+        EXPECT_TRUE(error.empty()) << error;
+        results[k] = detections;
+        calls[k]++;
+    }, 2);
+
+    for (size_t k = 0; k < BATCH_TEST_IMAGES; ++k) {
+        vector<Detection> expected = detector.detect(decode(paths[k]), 2);
+
+        EXPECT_EQ(calls[k], 1);
+        ASSERT_EQ(expected.size(), results[k].size());
+        for (size_t l = 0; l < expected.size(); ++l) {
+            EXPECT_EQ(expected[l].x, results[k][l].x);
+            EXPECT_EQ(expected[l].y, results[k][l].y);
+            EXPECT_EQ(expected[l].score, results[k][l].score);
+        }
+    }
+
+    ASSERT_EQ(stages.size(), 3);
+    for (const auto &stage : stages) {
+        EXPECT_EQ(stage.items, BATCH_TEST_IMAGES);
+        EXPECT_GT(stage.throughput(), 0.0);
+    }
+}
+
+TEST_F(BatchRunnerTest, Errors) {
+    vector<string> paths{"0", "not_a_number", "../img/test/not_a_file.png", "3"}, errors(paths.size());
+    vector<size_t> counts(paths.size(), 0);
+
+    // Images which can't be decoded are reported with their error, the other ones are processed
+    BatchRunner runner{detector, 2, 1, 1, 1};
+    runner.setDecoder([](const string &path) { return path[0] == '.' ? IMatrix(path) : decode(path); });
+    auto stages = runner.run(paths, [&](size_t k, const string &, const vector<Detection> &detections,
+                                        const string &error) {
+        errors[k] = error;
+        counts[k] = detections.size();
+    }, 2);
+
+    EXPECT_TRUE(errors[0].empty());
+    EXPECT_EQ(counts[0], detector.detect(decode(paths[0]), 2).size());
+    EXPECT_FALSE(errors[1].empty());
+    EXPECT_NE(errors[2].find(paths[2]), string::npos);
+    EXPECT_EQ(counts[2], 0);
+    EXPECT_TRUE(errors[3].empty());
+    EXPECT_EQ(counts[3], detector.detect(decode(paths[3]), 2).size());
+    EXPECT_EQ(stages[2].items, paths.size());
+}
+
+TEST_F(BatchRunnerTest, List) {
+    vector<string> paths = BatchRunner::list("../img/test", ".png");
+
+    ASSERT_EQ(paths.size(), 5);
+    EXPECT_EQ(paths[0], "../img/test/blank_black.png");
+    EXPECT_TRUE(BatchRunner::list("../img/not_a_dir").empty());
+}
@@ -0,0 +1,113 @@
+//
+// Created by Sami Dahoux on 2019-01-28.
+//
+
+#include <chrono>
+#include <algorithm>
+#include <Detector.h>
+
+#define BENCH_WIDTH 1080
+#define BENCH_HEIGHT 1920
+#define BENCH_FEATURES 8
+#define BENCH_RUNS 7
+
+using namespace std;
+
+// Median and relative spread (max - min) / median of the measures
+static pair<double_t, double_t> median(vector<double_t> measures) {
+    sort(measures.begin(), measures.end());
+    double_t mid = measures[measures.size() / 2];
+    return {mid, (measures.back() - measures.front()) / mid};
+}
+
+// Windows evaluated per second by detections on a 1080p frame with the given scan tiles, the runs of the tiles are
+// interleaved so that they see the same state of the machine
+static vector<pair<double_t, double_t> > throughput(Detector &detector, const IMatrix &img,
+                                                    const vector<size_t> &tiles, size_t windows) {
+    vector<vector<double_t> > measures(tiles.size());
+    vector<pair<double_t, double_t> > result;
+
+    for (size_t run = 0; run < BENCH_RUNS; ++run) {
+        for (size_t k = 0; k < tiles.size(); ++k) {
+            detector.setTile(tiles[k]);
+            auto begin = chrono::steady_clock::now();
+            detector.detect(img, 1, 4);
+            double_t elapsed = chrono::duration<double_t>(chrono::steady_clock::now() - begin).count();
+            measures[k].push_back(windows / elapsed);
+        }
+    }
+    for (const auto &m : measures) {
+        result.push_back(median(m));
+    }
+    return result;
+}
+
+// Windows evaluated per second on a band one at a time or P_HAAR_LANES at a time
+static double_t throughput(const Detector &detector, const IBand &band, bool lanes, size_t windows) {
+    double_t best = 0.0, scores[P_HAAR_LANES];
+    size_t found = 0;
+
+    for (size_t run = 0; run < BENCH_RUNS; ++run) {
+        auto begin = chrono::steady_clock::now();
+        for (size_t s = 1; s <= 4; ++s) {
+            size_t ws = s * detector.size();
+            for (size_t x = 0; x + ws <= band.width(); x += s) {
+                for (size_t y = 0; y + ws <= band.height(); y += (lanes ? P_HAAR_LANES * s : s)) {
+                    if (!lanes) {
+                        found += detector(band, x, y, s) >= 0.99;
+                        continue;
+                    }
+                    size_t n = std::min<size_t>(P_HAAR_LANES, (band.height() - ws - y) / s + 1);
+                    found += __builtin_popcount(detector(band, x, y, s, s, (uint32_t) ((1ul << n) - 1), scores));
+                }
+            }
+        }
+        double_t elapsed = chrono::duration<double_t>(chrono::steady_clock::now() - begin).count();
+        best = std::max(best, windows / elapsed);
+    }
+    return found > 0 ? best : 0.0;
+}
+
+int main() {
+    IMatrix img{mat_pix_t::zeros(BENCH_WIDTH, BENCH_HEIGHT)};
+    vector<WClassifier> h;
+    size_t windows = 0;
+
+    for (size_t x = 0; x < img.width(); ++x) {
+        for (size_t y = 0; y < img.height(); ++y) {
+            img(x, y) = Pixel((int) ((31 * x + 17 * y + (x * y) % 13) % 256));
+        }
+    }
+    img.intgr();
+
+    for (size_t k = 0; k < BENCH_FEATURES; ++k) {
+        h.emplace_back(PHaar(k, (2 * k) % 8, 12, 12, (PHaar::Type) (k % 4)), 10.0 * k - 40.0);
+    }
+    Detector detector{h, vec_t::ones(BENCH_FEATURES), P_HAAR_FEATURE_DEFAULT_SIZE, 0.99};
+
+    for (size_t s = 1; s <= 4; ++s) {
+        size_t ws = s * P_HAAR_FEATURE_DEFAULT_SIZE;
+        windows += ((BENCH_WIDTH - ws) / s + 1) * ((BENCH_HEIGHT - ws) / s + 1);
+    }
+
+    // Medians of BENCH_RUNS runs, a gain is only significant if it exceeds the spreads of the runs
+    vector<size_t> tiles{MAX_SIZE, 0, 32, 64, 128, 256};
+    auto medians = throughput(detector, img, tiles, windows);
+    double_t row_major = medians[0].first;
+    std::cout << "row-major : " << row_major << " windows/s (spread " << 100.0 * medians[0].second << "%)"
+              << std::endl;
+
+    for (size_t k = 1; k < tiles.size(); ++k) {
+        std::cout << "tile " << tiles[k] << (tiles[k] == 0 ? " (cache)" : "") << " : " << medians[k].first
+                  << " windows/s (" << 100.0 * (medians[k].first / row_major - 1.0) << "%, spread "
+                  << 100.0 * medians[k].second << "%)" << std::endl;
+    }
+
+    IBand band{img};
+    double_t single = throughput(detector, band, false, windows);
+    double_t lanes = throughput(detector, band, true, windows);
+    std::cout << "band : " << single << " windows/s" << std::endl;
+    std::cout << "band " << P_HAAR_LANES << " lanes " << PHaar::instructions() << " : " << lanes << " windows/s (x"
+              << lanes / single << ")" << std::endl;
+    return 0;
+}
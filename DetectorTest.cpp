@@ -0,0 +1,206 @@
+//
+// Created by Sami Dahoux on 2019-01-25.
+//
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <Detector.h>
+
+#define DETECTOR_TEST_SIZE 8
+
+using namespace std;
+
+class DetectorTest : public ::testing::Test {
+
+protected:
+
+    void SetUp() override {
+        // Vertical edges : bright band on the upper half of each 8x8 block of a checkerboard
+        for (size_t x = 0; x < img.width(); ++x) {
+            for (size_t y = 0; y < img.height(); ++y) {
+                img(x, y) = Pixel(((x / 4) % 2 == 0 && (y / 8) % 2 == 0) ? 255 : 0);
+            }
+        }
+    }
+
+public:
+    IMatrix img{mat_pix_t::zeros(50, 44)};
+
+    vector<WClassifier> h{
+            WClassifier(PHaar(0, 0, DETECTOR_TEST_SIZE, DETECTOR_TEST_SIZE, PHaar::TwoRectW), 1000.0),
+            WClassifier(PHaar(0, 0, DETECTOR_TEST_SIZE, DETECTOR_TEST_SIZE, PHaar::FourRect), -1000.0)
+    };
+    Detector detector{h, vec_t{2.0, 1.0}, DETECTOR_TEST_SIZE};
+};
+
+TEST_F(DetectorTest, Detect) {
+    vector<Detection> detections = detector.detect(img);
+
+    ASSERT_FALSE(detections.empty());
+    for (const auto &d : detections) {
+        EXPECT_GE(d.score, 0.5);
+        EXPECT_LE(d.x + d.w, img.width());
+        EXPECT_LE(d.y + d.h, img.height());
+        EXPECT_EQ(d.score, detector(img, d.x, d.y, d.w / DETECTOR_TEST_SIZE));
+    }
+}
+
+TEST_F(DetectorTest, DetectTiled) {
+    vector<Detection> expected = detector.detect(img, 2), tiled;
+    size_t max_area = 0;
+    const IMatrix &src = img;
+    mutex area_mutex;
+
+    Detector::TileSource source = [&](size_t x, size_t y, size_t tw, size_t th) {
+        lock_guard<mutex> lock(area_mutex);
+        max_area = std::max(max_area, tw * th);
+        return IMatrix(src(x, y, x + tw - 1, y + th - 1));
+    };
+
+    // Budget fits tiles of about 60 x 60 pixels for each thread, which forces splitting on the biggest scales
+    size_t budget = 3 * 60 * 60 * DETECTOR_TILE_FOOTPRINT * sizeof(Pixel);
+    tiled = detector.detectTiled(img.width(), img.height(), source, budget, 2, 0, 3);
+
+    ASSERT_EQ(expected.size(), tiled.size());
+    for (size_t k = 0; k < expected.size(); ++k) {
+        EXPECT_EQ(expected[k].x, tiled[k].x);
+        EXPECT_EQ(expected[k].y, tiled[k].y);
+        EXPECT_EQ(expected[k].w, tiled[k].w);
+        EXPECT_EQ(expected[k].score, tiled[k].score);
+    }
+    EXPECT_LE(max_area, 60 * 60);
+
+    // Small tiles limited to the smallest scale
+    tiled = detector.detectTiled(img, 4 * 20 * 20 * DETECTOR_TILE_FOOTPRINT * sizeof(Pixel), 2, 1, 4);
+    expected = detector.detect(img, 2, 1);
+    ASSERT_EQ(expected.size(), tiled.size());
+
+    // Windows are bounded by the tiles, 30 x 30 pixels hold the scales up to 3
+    max_area = 0;
+    budget = 30 * 30 * DETECTOR_TILE_FOOTPRINT * sizeof(Pixel);
+    tiled = detector.detectTiled(img.width(), img.height(), source, budget, 2);
+    expected = detector.detect(img, 2, 3);
+    ASSERT_EQ(expected.size(), tiled.size());
+    for (size_t k = 0; k < expected.size(); ++k) {
+        EXPECT_EQ(expected[k].x, tiled[k].x);
+        EXPECT_EQ(expected[k].y, tiled[k].y);
+        EXPECT_EQ(expected[k].w, tiled[k].w);
+    }
+    EXPECT_LE(max_area, 30 * 30);
+
+    // The budget can't hold a window of scale 1
+    EXPECT_THROW(detector.detectTiled(img, 8 * 8 * DETECTOR_TILE_FOOTPRINT * sizeof(Pixel)), std::invalid_argument);
+}
+
+TEST_F(DetectorTest, DetectStream) {
+    vector<Detection> expected = detector.detect(img), streamed;
+    size_t x = 0;
+
+    Detector::RowSource source = [this, &x](vec_pix_t &row) {
+        if (x == img.width())
+            return false;
+        row = img.row(x++);
+        return true;
+    };
+    Detector::DetectionSink sink = [&streamed, &x](const Detection &d) {
+        // Detections are available as soon as the last row of the window is read
+        EXPECT_EQ(d.x + d.w, x);
+        streamed.push_back(d);
+    };
+
+    detector.detectStream(img.height(), source, sink);
+    sort(streamed.begin(), streamed.end());
+
+    ASSERT_EQ(expected.size(), streamed.size());
+    for (size_t k = 0; k < expected.size(); ++k) {
+        EXPECT_EQ(expected[k].x, streamed[k].x);
+        EXPECT_EQ(expected[k].y, streamed[k].y);
+        EXPECT_EQ(expected[k].w, streamed[k].w);
+        EXPECT_EQ(expected[k].score, streamed[k].score);
+    }
+}
+
+TEST_F(DetectorTest, DetectAnytime) {
+    auto now = chrono::steady_clock::now();
+    AnytimeResult full = detector.detectAnytime(img, now + chrono::hours(1), 2),
+            over = detector.detectAnytime(img, now - chrono::seconds(1), 2);
+    vector<Detection> expected = detector.detect(img, 2);
+
+    EXPECT_TRUE(full.complete);
+    EXPECT_EQ(full.coverage, 1.0);
+    ASSERT_EQ(expected.size(), full.detections.size());
+
+    // Best detections first
+    for (size_t k = 1; k < full.detections.size(); ++k) {
+        EXPECT_GE(full.detections[k - 1].score, full.detections[k].score);
+    }
+
+    sort(full.detections.begin(), full.detections.end());
+    for (size_t k = 0; k < expected.size(); ++k) {
+        EXPECT_EQ(expected[k].x, full.detections[k].x);
+        EXPECT_EQ(expected[k].y, full.detections[k].y);
+        EXPECT_EQ(expected[k].w, full.detections[k].w);
+    }
+
+    EXPECT_FALSE(over.complete);
+    EXPECT_EQ(over.coverage, 0.0);
+    EXPECT_TRUE(over.detections.empty());
+}
+
+TEST_F(DetectorTest, DetectAnytimeShared) {
+    IMatrix large{mat_pix_t::zeros(160, 120)};
+    Detector all{h, vec_t{2.0, 1.0}, DETECTOR_TEST_SIZE, 0.0};
+    size_t step = 2;
+
+    // Level of a window, the coarsest grid its corner is on
+    auto level = [step](const Detection &d) {
+        size_t stride = d.w / DETECTOR_TEST_SIZE * step, l = 0;
+        while (l + 1 < DETECTOR_ANYTIME_LEVELS && d.x % (stride << (l + 1)) == 0 && d.y % (stride << (l + 1)) == 0) {
+            l++;
+        }
+        return l;
+    };
+
+    // Each window is a detection, so that detections are the evaluated windows
+    auto begin = chrono::steady_clock::now();
+    vector<Detection> expected = all.detectAnytime(large, begin + chrono::hours(1), step).detections;
+    auto full = chrono::steady_clock::now() - begin;
+
+    // Shorter deadlines share the time of the finer levels between the scales, the windows of the levels coarser
+    // than the finest one reached must all have been evaluated anyway
+    for (long k = 1; k < 40; ++k) {
+        AnytimeResult partial = all.detectAnytime(large, chrono::steady_clock::now() + full * k / 40, step);
+        size_t finest = DETECTOR_ANYTIME_LEVELS, coarser = 0, expected_coarser = 0;
+
+        for (const auto &d : partial.detections) {
+            finest = min(finest, level(d));
+        }
+        for (const auto &d : partial.detections) {
+            coarser += level(d) > finest;
+        }
+        for (const auto &d : expected) {
+            expected_coarser += level(d) > finest;
+        }
+        EXPECT_EQ(coarser, expected_coarser) << k;
+        EXPECT_EQ(partial.coverage, (double_t) partial.detections.size() / expected.size()) << k;
+        EXPECT_EQ(partial.complete, partial.detections.size() == expected.size()) << k;
+    }
+}
+
+TEST_F(DetectorTest, ScanTile) {
+    // Row-major scan unless a tile is set
+    EXPECT_EQ(detector.tile(), MAX_SIZE);
+    vector<Detection> expected = detector.detect(img);
+    EXPECT_TRUE(is_sorted(expected.begin(), expected.end()));
+
+    for (size_t tile : {0, 1, 5, 16}) {
+        vector<Detection> tiled = detector.setTile(tile).detect(img);
+
+        ASSERT_EQ(expected.size(), tiled.size());
+        for (size_t k = 0; k < expected.size(); ++k) {
+            EXPECT_EQ(expected[k].x, tiled[k].x);
+            EXPECT_EQ(expected[k].y, tiled[k].y);
+            EXPECT_EQ(expected[k].w, tiled[k].w);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+//
+// Created by Sami Dahoux on 2019-01-26.
+//
+
+#include <gtest/gtest.h>
+#include <IBand.h>
+
+class IBandTest : public ::testing::Test {
+
+protected:
+
+    void SetUp() override {
+        for (size_t x = 0; x < img.width(); ++x) {
+            for (size_t y = 0; y < img.height(); ++y) {
+                img(x, y) = Pixel((int) ((7 * x + 3 * y) % 256));
+            }
+        }
+    }
+
+public:
+    IMatrix img{mat_pix_t::zeros(30, 20)};
+};
+
+TEST_F(IBandTest, Integral) {
+    IBand band{img};
+    mat_pix_t &intgr = img.intgr();
+
+    ASSERT_EQ(band.width(), 30);
+    ASSERT_EQ(band.height(), 20);
+
+    for (size_t x = 0; x < img.width(); ++x) {
+        for (size_t y = 0; y < img.height(); ++y) {
+            EXPECT_EQ(band(x, y), 3 * intgr(x, y).grey());
+        }
+    }
+}
+
+TEST_F(IBandTest, Rolling) {
+    IBand band{img.height(), 8};
+
+    for (size_t x = 0; x < img.width(); ++x) {
+        band.push(img.row(x));
+
+        EXPECT_EQ(band.first(), x >= 8 ? x - 7 : 0);
+        for (size_t x1 = band.first(); x1 <= x; ++x1) {
+            EXPECT_EQ(band.sum(x1, 2, x, 17), 3 * img.sum(x1, 2, x, 17).grey());
+        }
+    }
+}
+
+TEST_F(IBandTest, PushScanline) {
+    IBand band{img.height(), 4}, scan_band{img.height(), 4};
+    std::vector<uc_t> line(img.height());
+
+    for (size_t x = 0; x < 10; ++x) {
+        for (size_t y = 0; y < img.height(); ++y) {
+            line[y] = (uc_t) img(x, y).grey();
+        }
+        band.push(img.row(x));
+        scan_band.push(line.data());
+    }
+
+    for (size_t y = 0; y < img.height(); ++y) {
+        EXPECT_EQ(band(9, y), scan_band(9, y));
+    }
+}
@@ -49,4 +49,41 @@ TEST_F(IMatrixTest, SumWithin) {
     fill_1.fill(1);
 
     ASSERT_EQ(fill_1.sum(0, 0, 1, 1), 1);
-}
\ No newline at end of file
+}
+TEST_F(IMatrixTest, Move) {
+    IMatrix fill_1{mat_pix_t::zeros(10)}, expect_crop{mat_pix_t::zeros(3, 2)};
+    fill_1.fill(1);
+    expect_crop.fill(1);
+
+    // Integral image is taken along with the pixels
+    Pixel sum = fill_1.sum(0, 0, 9, 9);
+    IMatrix moved{std::move(fill_1)};
+
+    EXPECT_EQ(moved.width(), 10);
+    EXPECT_EQ(fill_1.width(), 0);
+    EXPECT_EQ(moved.sum(0, 0, 9, 9), sum);
+
+    // Only the browsed sub-matrix is taken
+    IMatrix crop{std::move(moved(2, 3, 4, 4))};
+    EXPECT_EQ(crop, expect_crop);
+
+    std::vector<IMatrix> images;
+    for (size_t k = 0; k < 8; ++k) {
+        images.push_back(IMatrix(k + 1, k + 1));
+    }
+    EXPECT_EQ(images[7].width(), 8);
+
+    // Moving into a browsed image drops the integral image of both
+    IMatrix dst{mat_pix_t::zeros(6)}, block{mat_pix_t::zeros(3)};
+    dst.fill(1);
+    block.fill(50);
+    dst.sum(0, 0, 5, 5);
+    block.sum(0, 0, 2, 2);
+
+    dst(0, 0, 2, 2);
+    dst = std::move(block);
+
+    IMatrix expect_dst{(mat_pix_t) dst};
+    EXPECT_EQ(dst.sum(0, 0, 5, 5), expect_dst.sum(0, 0, 5, 5));
+    EXPECT_EQ(dst.sum(1, 1, 4, 3), expect_dst.sum(1, 1, 4, 3));
+}
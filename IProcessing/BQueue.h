@@ -0,0 +1,203 @@
+//
+// Created by bendou on 27/01/19.
+//
+
+#ifndef FACEDETECTION_BQUEUE_H
+#define FACEDETECTION_BQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cassert>
+
+/**
+ * @class          : BQueue
+ * @brief          : Bounded lock-free multi-producer multi-consumer FIFO queue.
+ *                   The queue is a ring of cells tagged with a sequence number telling whether the cell is ready to
+ *                   be written or read at a given position (D. Vyukov's bounded MPMC queue).
+ *
+ *                   tryPush() fails when the queue is full, which gives backpressure to the producers.
+ *
+ *                   push() and pop() sleep on a condition variable while the queue is full or empty, instead of
+ *                   spinning. The lock is only taken when a thread waits, the queue stays lock-free otherwise.
+ *                   close() tells the consumers that no element will be pushed anymore.
+ */
+template<typename T>
+class BQueue {
+
+public:
+
+    /**
+     * @brief Construct a queue holding at least capacity elements. Capacity is rounded to a power of 2.
+     * @details The ring has at least 2 cells, a single cell can't tell a full queue from an empty one.
+     */
+    explicit BQueue(size_t capacity) : _mask(0), _head(0), _tail(0), _waiting(0), _closed(false) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _mask = size - 1;
+        _cells.reset(new Cell[size]);
+        for (size_t k = 0; k < size; ++k) {
+            _cells[k].seq.store(k, std::memory_order_relaxed);
+        }
+    }
+
+    BQueue(const BQueue &) = delete;
+
+    BQueue &operator=(const BQueue &) = delete;
+
+    inline size_t capacity() const {return _mask + 1;}
+
+    /**
+     * @brief Moves value at the back of the queue.
+     * @return false if the queue is full, value is left untouched.
+     */
+    bool tryPush(T &value) {
+        if (!put(value))
+            return false;
+        wake();
+        return true;
+    }
+
+    /**
+     * @brief Moves the front of the queue into value.
+     * @return false if the queue is empty.
+     */
+    bool tryPop(T &value) {
+        if (!take(value))
+            return false;
+        wake();
+        return true;
+    }
+
+    /**
+     * @brief Moves value at the back of the queue, waits while the queue is full.
+     */
+    void push(T &value) {
+        wait([this, &value]() { return put(value); });
+        wake();
+    }
+
+    /**
+     * @brief Moves the front of the queue into value, waits while the queue is empty and not closed.
+     * @return false if the queue is closed and empty.
+     */
+    bool pop(T &value) {
+        bool popped = false;
+
+        // Elements pushed before the queue was closed are visible once closed is read
+        wait([this, &value, &popped]() {
+            popped = take(value) || (_closed.load(std::memory_order_acquire) && take(value));
+            return popped || _closed.load(std::memory_order_acquire);
+        });
+        if (popped)
+            wake();
+        return popped;
+    }
+
+    /**
+     * @brief Wakes up the consumers waiting on an empty queue, pop() fails once the queue is empty.
+     */
+    void close() {
+        _closed.store(true, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _changed.notify_all();
+    }
+
+private:
+
+    // Lock-free push and pop, which don't wake the waiting threads
+    bool put(T &value) {
+        Cell *cell;
+        size_t pos = _tail.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &_cells[pos & _mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = (long) seq - (long) pos;
+            if (diff == 0) {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool take(T &value) {
+        Cell *cell;
+        size_t pos = _head.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &_cells[pos & _mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = (long) seq - (long) (pos + 1);
+            if (diff == 0) {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->seq.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Sleeps until ready() holds, ready() is called again, with the lock held, each time the queue changes
+    template<typename F>
+    void wait(const F &ready) {
+        if (ready())
+            return;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _waiting++;
+        // Either the waiter sees the last change, or the thread making it sees the waiter and notifies it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        _changed.wait(lock, ready);
+        _waiting--;
+    }
+
+    // Notifies the waiting threads of a change, without locking when there are none
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_waiting.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _changed.notify_all();
+        }
+    }
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> _cells;
+
+    size_t _mask;
+
+    // Producers and consumers indices on separate cache lines
+    alignas(64) std::atomic<size_t> _head;
+
+    alignas(64) std::atomic<size_t> _tail;
+
+    std::atomic<size_t> _waiting;
+
+    std::atomic<bool> _closed;
+
+    std::mutex _mutex;
+
+    std::condition_variable _changed;
+};
+
+
+#endif //FACEDETECTION_BQUEUE_H
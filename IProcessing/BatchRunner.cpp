@@ -0,0 +1,141 @@
+//
+// Created by bendou on 27/01/19.
+//
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include "BatchRunner.h"
+
+using namespace std::chrono;
+
+// Runs f unless a previous stage failed on the image, an exception becomes the error of the image instead of ending
+// the batch
+template<typename F>
+static void attempt(std::string &error, const F &f) {
+    if (!error.empty())
+        return;
+    try {
+        f();
+    } catch (const std::exception &e) {
+        error = e.what();
+    } catch (...) {
+        error = "unknown error";
+    }
+}
+
+BatchRunner::BatchRunner(const Detector &detector, size_t decoders, size_t integrators, size_t scanners,
+                         size_t queue) : _detector(detector), _queue(queue) {
+    size_t half = std::max<size_t>(1, std::thread::hardware_concurrency() / 2);
+
+    _decoder = [](const std::string &path) { return IMatrix(path); };
+    _stages = {
+            {"decode",   decoders > 0 ? decoders : half,       0, 0.0, 0.0, 0},
+            {"integral", integrators > 0 ? integrators : half, 0, 0.0, 0.0, 0},
+            {"scan",     scanners > 0 ? scanners : half,       0, 0.0, 0.0, 0}
+    };
+}
+
+const std::vector<BatchRunner::Stage> &BatchRunner::run(const std::vector<std::string> &paths, const ResultSink &sink,
+                                                        size_t step, size_t max_scale) {
+    BQueue<JobPtr> decoded(_queue), integrated(_queue);
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> pool;
+
+    // Waits for a job of queue, until the stage feeding queue is over
+    auto pop = [](BQueue<JobPtr> &queue) {
+        return [&queue](JobPtr &job) { return queue.pop(job); };
+    };
+
+    for (auto &stage : _stages) {
+        stage.items = 0;
+        stage.busy = 0.0;
+        stage.wall = 0.0;
+        stage.stalls = 0;
+    }
+    _start = steady_clock::now();
+
+    start(_stages[0], [&next, &paths](JobPtr &job) {
+        size_t k = next++;
+        if (k >= paths.size())
+            return false;
+        job.reset(new Job{k, IMatrix(), {}, ""});
+        return true;
+    }, [this, &paths](Job &job) {
+        attempt(job.error, [this, &paths, &job]() { job.img = _decoder(paths[job.index]); });
+    }, &decoded, pool);
+
+    start(_stages[1], pop(decoded), [](Job &job) {
+        attempt(job.error, [&job]() { job.img.intgr(); });
+    }, &integrated, pool);
+
+    start(_stages[2], pop(integrated), [&](Job &job) {
+        attempt(job.error, [&]() { job.detections = _detector.detect(job.img, step, max_scale); });
+        std::lock_guard<std::mutex> lock(_mutex);
+        sink(job.index, paths[job.index], job.detections, job.error);
+    }, nullptr, pool);
+
+    for (auto &thread : pool) {
+        thread.join();
+    }
+    return _stages;
+}
+
+std::vector<std::string> BatchRunner::list(const std::string &dir, const std::string &extension) {
+    std::vector<std::string> paths;
+    DIR *handle = opendir(dir.c_str());
+    struct stat info{};
+
+    if (handle == nullptr)
+        return paths;
+
+    for (dirent *entry = readdir(handle); entry != nullptr; entry = readdir(handle)) {
+        std::string name{entry->d_name}, path{dir + "/" + name};
+        bool match = name.size() >= extension.size() &&
+                     name.compare(name.size() - extension.size(), extension.size(), extension) == 0;
+        if (match && stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+            paths.push_back(path);
+    }
+    closedir(handle);
+
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+void BatchRunner::start(Stage &stage, const JobSource &source, const JobWork &work, BQueue<JobPtr> *out,
+                        std::vector<std::thread> &pool) {
+    auto running = std::make_shared<std::atomic<size_t> >(stage.threads);
+
+    for (size_t t = 0; t < stage.threads; ++t) {
+        pool.emplace_back([this, &stage, source, work, out, running]() {
+            size_t items = 0, stalls = 0;
+            double_t busy = 0.0, last = 0.0;
+            JobPtr job;
+
+            while (source(job)) {
+                auto begin = steady_clock::now();
+                work(*job);
+                auto end = steady_clock::now();
+
+                busy += duration<double_t>(end - begin).count();
+                last = duration<double_t>(end - _start).count();
+                items++;
+
+                // Backpressure : waits for the next stage to make room
+                if (out != nullptr && !out->tryPush(job)) {
+                    stalls++;
+                    out->push(job);
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                stage.items += items;
+                stage.busy += busy;
+                stage.stalls += stalls;
+                stage.wall = std::max(stage.wall, last);
+            }
+            if (--(*running) == 0 && out != nullptr)
+                out->close();
+        });
+    }
+}
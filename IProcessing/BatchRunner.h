@@ -0,0 +1,125 @@
+//
+// Created by bendou on 27/01/19.
+//
+
+#ifndef FACEDETECTION_BATCHRUNNER_H
+#define FACEDETECTION_BATCHRUNNER_H
+
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include "Detector.h"
+#include "BQueue.h"
+
+#define BATCH_RUNNER_DEFAULT_QUEUE 8
+
+/**
+ * @class          : BatchRunner
+ * @brief          : Runs a detector on a batch of image files through a three stages pipeline :
+ *                      - decode : reads the images, on decoders threads
+ *                      - integral : computes the integral images, on integrators threads
+ *                      - scan : slides the detector on the images, on scanners threads
+ *
+ *                   Stages are connected by bounded lock-free queues. A stage waits when its output queue is full,
+ *                   so at most 2 x queue + threads images are in memory and decoding overlaps with computations.
+ *                   Idle threads sleep on the queues, leaving the cores to the busy stages.
+ *
+ *                   An image which fails to be decoded or processed is reported with its error, the other images
+ *                   of the batch are processed normally.
+ */
+class BatchRunner {
+
+public:
+
+    typedef std::function<IMatrix(const std::string &)> Decoder;
+
+    /**
+     * @brief Receives the index and the path of an image with its detections and its error.
+     * @details Calls are serialized but images come in any order. The error is the message of the exception thrown
+     *          while decoding or processing the image, it is empty when the image was processed.
+     */
+    typedef std::function<void(size_t, const std::string &, const std::vector<Detection> &,
+                               const std::string &)> ResultSink;
+
+    /**
+     * @brief Statistics of a stage of the pipeline for the last run.
+     */
+    struct Stage {
+        std::string name;
+        size_t threads;
+        size_t items;
+        // Time spent processing items in seconds, summed over threads
+        double_t busy;
+        // Time between the beginning of the run and the last item processed in seconds
+        double_t wall;
+        // Number of times a thread waited for room in the output queue
+        size_t stalls;
+
+        /**
+         * @return Number of items processed per second.
+         */
+        inline double_t throughput() const {return wall > 0 ? items / wall : 0.0;}
+    };
+
+    /**
+     * @brief Construct a pipeline running detector. A number of threads of 0 uses half the hardware threads.
+     */
+    explicit BatchRunner(const Detector &detector, size_t decoders = 0, size_t integrators = 1, size_t scanners = 0,
+                         size_t queue = BATCH_RUNNER_DEFAULT_QUEUE);
+
+    inline const std::vector<Stage> &stages() const {return _stages;}
+
+    /**
+     * @brief Replace the default decoder which reads images with IMatrix(path).
+     */
+    inline BatchRunner &setDecoder(const Decoder &decoder) {_decoder = decoder; return *this;}
+
+    /**
+     * @brief Processes all the images and give detections to sink as soon as they are available.
+     * @return Statistics of each stage.
+     */
+    const std::vector<Stage> &run(const std::vector<std::string> &paths, const ResultSink &sink,
+                                  size_t step = DETECTOR_DEFAULT_STEP, size_t max_scale = 0);
+
+    /**
+     * @return Sorted paths of the regular files of dir ending with extension.
+     */
+    static std::vector<std::string> list(const std::string &dir, const std::string &extension = "");
+
+private:
+
+    struct Job {
+        size_t index;
+        IMatrix img;
+        std::vector<Detection> detections;
+        std::string error;
+    };
+
+    typedef std::unique_ptr<Job> JobPtr;
+
+    typedef std::function<bool(JobPtr &)> JobSource;
+
+    typedef std::function<void(Job &)> JobWork;
+
+    /**
+     * @brief Starts the threads of a stage taking jobs from source and pushing them to out once processed.
+     * @details out is closed when all the threads of the stage are over.
+     */
+    void start(Stage &stage, const JobSource &source, const JobWork &work, BQueue<JobPtr> *out,
+               std::vector<std::thread> &pool);
+
+    Detector _detector;
+
+    Decoder _decoder;
+
+    size_t _queue;
+
+    std::vector<Stage> _stages;
+
+    std::chrono::steady_clock::time_point _start;
+
+    std::mutex _mutex;
+};
+
+
+#endif //FACEDETECTION_BATCHRUNNER_H
@@ -0,0 +1,358 @@
+//
+// Created by bendou on 25/01/19.
+//
+
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include "Detector.h"
+
+// Smallest multiple of a greater or equal to v
+static inline size_t alignUp(size_t v, size_t a) { return (v + a - 1) / a * a; }
+
+// Size of the entries of the integral images
+static inline size_t entrySize(const IMatrix &) { return sizeof(Pixel); }
+
+static inline size_t entrySize(const IBand &) { return sizeof(uint32_t); }
+
+// Number of windows evaluated at once
+static inline size_t lanes(const IMatrix &) { return 1; }
+
+static inline size_t lanes(const IBand &) { return P_HAAR_LANES; }
+
+Detector::Detector(const std::vector<WClassifier> &h, const vec_t &alpha, size_t size, double_t theta) :
+        _h(h), _alpha(alpha), _norm(0.0), _size(size), _theta(theta), _tile(MAX_SIZE) {
+
+    assert(_h.size() == _alpha.size());
+    for (size_t t = 0; t < _alpha.size(); ++t) {
+        _norm += _alpha[t];
+    }
+}
+
+template<typename I>
+double_t Detector::operator()(const I &img, size_t x, size_t y, size_t s) const {
+    double_t score = 0.0, left = _norm, min_score = _theta * _norm;
+
+    for (size_t t = 0; t < _h.size() && score + left >= min_score; ++t) {
+        left -= _alpha[t];
+        if (_h[t].classify(_h[t].f.placed(x, y, s)(img)))
+            score += _alpha[t];
+    }
+    return _norm > 0 ? score / _norm : 0.0;
+}
+
+uint32_t Detector::operator()(const IBand &img, size_t x, size_t y, size_t s, size_t stride, uint32_t mask,
+                              double_t *scores) const {
+    double_t left = _norm, min_score = _theta * _norm;
+    int32_t sums[P_HAAR_LANES];
+    uint32_t found = 0, active = left >= min_score ? mask : 0;
+
+    for (size_t k = 0; k < P_HAAR_LANES; ++k) {
+        scores[k] = 0.0;
+    }
+
+    // Same cascade than the single window operator, a lane drops out when its test fails
+    for (size_t t = 0; t < _h.size() && active != 0; ++t) {
+        left -= _alpha[t];
+        _h[t].f.placed(x, y, s).lanes(img, stride, active, sums);
+        for (size_t k = 0; k < P_HAAR_LANES; ++k) {
+            if ((active >> k & 1) && _h[t].classify(sums[k] / 3))
+                scores[k] += _alpha[t];
+            if (scores[k] + left < min_score)
+                active &= ~(1u << k);
+        }
+    }
+
+    for (size_t k = 0; k < P_HAAR_LANES; ++k) {
+        scores[k] = _norm > 0 ? scores[k] / _norm : 0.0;
+        if ((mask >> k & 1) && scores[k] >= _theta)
+            found |= 1u << k;
+    }
+    return found;
+}
+
+std::vector<Detection> Detector::detect(const IMatrix &img, size_t step, size_t max_scale) const {
+    std::vector<Detection> detections;
+    size_t width = img.width(), height = img.height();
+
+    max_scale = maxScale(width, height, max_scale);
+    for (size_t s = 1; s <= max_scale; ++s) {
+        scan(img, 0, 0, width, height, 0, 0, step, s, detections);
+    }
+
+    // Tiles give windows out of scan order
+    if (_tile != MAX_SIZE)
+        std::sort(detections.begin(), detections.end());
+    return detections;
+}
+
+std::vector<Detection> Detector::detectTiled(const IMatrix &img, size_t budget, size_t step, size_t max_scale,
+                                             size_t threads) const {
+    // Tiles are cropped from the decoded image, the budget only bounds tiles and their integral images
+    TileSource crop = [&img](size_t x, size_t y, size_t w, size_t h) {
+        return IMatrix(img(x, y, x + w - 1, y + h - 1));
+    };
+    return detectTiled(img.width(), img.height(), crop, budget, step, max_scale, threads);
+}
+
+std::vector<Detection> Detector::detectTiled(size_t width, size_t height, const TileSource &source, size_t budget,
+                                             size_t step, size_t max_scale, size_t threads) const {
+    std::vector<Detection> detections;
+    auto side = [budget](size_t n) {
+        return (size_t) std::sqrt((double_t) budget / (n * DETECTOR_TILE_FOOTPRINT * sizeof(Pixel)));
+    };
+
+    // A single tile must hold the biggest window and one pixel of core
+    if (side(1) < _size + 1)
+        throw std::invalid_argument("Detector::detectTiled : memory budget can't hold a single window");
+
+    max_scale = maxScale(width, height, std::min((side(1) - 1) / _size, max_scale == 0 ? MAX_SIZE : max_scale));
+    if (max_scale == 0)
+        return detections;
+
+    // Tiles overlap by the biggest window minus one pixel so that any window fits in the tile owning its corner
+    size_t margin = max_scale * _size - 1;
+
+    if (threads == 0)
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    while (threads > 1 && side(threads) < margin + 2) {
+        threads--;
+    }
+
+    size_t core = std::min(side(threads) - margin - 1, std::max(width, height));
+    size_t nx = (width + core - 1) / core, ny = (height + core - 1) / core;
+    threads = std::min(threads, nx * ny);
+
+    std::vector<std::vector<Detection> > found(nx * ny);
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t k = next++; k < nx * ny; k = next++) {
+            size_t x = (k / ny) * core, y = (k % ny) * core;
+            size_t w = std::min(core + margin, width - x), h = std::min(core + margin, height - y);
+            IMatrix tile = source(x, y, w, h);
+            for (size_t s = 1; s <= max_scale; ++s) {
+                scan(tile, 0, 0, std::min(core, w), std::min(core, h), x, y, step, s, found[k]);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : pool) {
+        thread.join();
+    }
+
+    for (const auto &tile_detections : found) {
+        detections.insert(detections.end(), tile_detections.begin(), tile_detections.end());
+    }
+
+    // Same ordering as a single scan
+    std::sort(detections.begin(), detections.end());
+    return detections;
+}
+
+std::vector<Detection> Detector::detect(const IBand &band, size_t step, size_t max_scale) const {
+    std::vector<Detection> detections;
+
+    max_scale = maxScale(band.rows(), band.height(), max_scale);
+    for (size_t s = 1; s <= max_scale && s * _size <= band.width(); ++s) {
+        // Only the windows whose last row is the last pushed one
+        size_t x = band.width() - s * _size;
+        scan(band, x, 0, x + 1, band.height(), 0, 0, step, s, detections);
+    }
+    return detections;
+}
+
+void Detector::detectStream(size_t height, const RowSource &source, const DetectionSink &sink, size_t step,
+                            size_t max_scale) const {
+    max_scale = maxScale(height, height, max_scale);
+    if (max_scale == 0)
+        return;
+
+    IBand band(height, max_scale * _size);
+    vec_pix_t row(height);
+
+    while (source(row)) {
+        band.push(row);
+        for (const auto &detection : detect(band, step, max_scale)) {
+            sink(detection);
+        }
+    }
+}
+
+AnytimeResult Detector::detectAnytime(const IMatrix &img, std::chrono::steady_clock::time_point deadline,
+                                      size_t step, size_t max_scale) const {
+    typedef std::chrono::steady_clock clock;
+
+    // Scan of the windows of a scale on a level, resumed where it stopped at the next levels
+    struct Pass {
+        size_t x, y, cost, done;
+    };
+
+    AnytimeResult result{{}, 0.0, false};
+    size_t width = img.width(), height = img.height(), total = 0, evaluated = 0;
+    double_t per_window = 0.0, elapsed = 0.0;
+
+    // Number of windows of size ws with corners on a stride grid along a side of length n
+    auto count = [](size_t n, size_t ws, size_t stride) { return n >= ws ? (n - ws) / stride + 1 : 0; };
+
+    max_scale = maxScale(width, height, max_scale);
+    std::vector<std::vector<Pass> > passes(DETECTOR_ANYTIME_LEVELS, std::vector<Pass>(max_scale + 1, {0, 0, 0, 0}));
+
+    // Windows of a level are on the stride grid but not on the twice coarser grid of the previous level
+    for (long level = DETECTOR_ANYTIME_LEVELS - 1; level >= 0; --level) {
+        bool coarsest = level == DETECTOR_ANYTIME_LEVELS - 1;
+        for (size_t s = 1; s <= max_scale; ++s) {
+            size_t ws = s * _size, stride = (s * step) << level;
+            passes[level][s].cost = count(width, ws, stride) * count(height, ws, stride) -
+                                    (coarsest ? 0 : count(width, ws, 2 * stride) * count(height, ws, 2 * stride));
+            total += passes[level][s].cost;
+        }
+    }
+
+    // Scans the windows left by a pass until they are all evaluated or until is reached, at least one window is
+    // evaluated before deadline so that the scan always progresses
+    auto resume = [&](long level, size_t s, clock::time_point until) {
+        Pass &pass = passes[level][s];
+        size_t ws = s * _size, stride = (s * step) << level, done = pass.done;
+        bool coarsest = level == DETECTOR_ANYTIME_LEVELS - 1;
+        auto begin = clock::now();
+
+        for (; pass.x + ws <= width; pass.x += stride, pass.y = 0) {
+            for (; pass.y + ws <= height; pass.y += stride) {
+                if (!coarsest && pass.x % (2 * stride) == 0 && pass.y % (2 * stride) == 0)
+                    continue;
+
+                size_t checked = pass.done - done;
+                if (checked % DETECTOR_ANYTIME_CHECK == 0 && clock::now() >= (checked == 0 ? deadline : until))
+                    break;
+                double_t score = (*this)(img, pass.x, pass.y, s);
+                if (score >= _theta)
+                    result.detections.push_back({pass.x, pass.y, ws, ws, score});
+                pass.done++;
+            }
+            if (pass.y + ws <= height)
+                break;
+        }
+
+        // Running estimation of the time taken by a window
+        elapsed += std::chrono::duration<double_t>(clock::now() - begin).count();
+        evaluated += pass.done - done;
+        per_window = evaluated > 0 ? elapsed / evaluated : 0.0;
+    };
+
+    // The last round finishes the windows left on the finest level
+    for (long level = DETECTOR_ANYTIME_LEVELS - 1; level >= -1 && clock::now() < deadline; --level) {
+        size_t level_cost = 0;
+
+        // Windows left by the coarser levels are evaluated before the ones of the level, so that the grid is
+        // refined in order
+        for (long coarser = DETECTOR_ANYTIME_LEVELS - 1; coarser > level; --coarser) {
+            for (size_t s = max_scale; s >= 1; --s) {
+                if (passes[coarser][s].done < passes[coarser][s].cost)
+                    resume(coarser, s, deadline);
+            }
+        }
+
+        for (size_t s = 1; s <= max_scale && level >= 0; ++s) {
+            level_cost += passes[level][s].cost;
+        }
+        for (size_t s = max_scale; s >= 1 && level_cost > 0; --s) {
+            auto begin = clock::now();
+            auto scale_deadline = deadline;
+            double_t left = std::chrono::duration<double_t>(deadline - begin).count();
+            size_t cost = passes[level][s].cost;
+
+            // Shares the time left between the remaining scales if the level can't be completed, the windows
+            // a scale didn't reach are evaluated before the next level
+            if (per_window * level_cost > left) {
+                std::chrono::duration<double_t> share{left * cost / level_cost};
+                scale_deadline = begin + std::chrono::duration_cast<clock::duration>(share);
+            }
+            if (begin < deadline)
+                resume(level, s, scale_deadline);
+            level_cost -= cost;
+        }
+    }
+
+    std::sort(result.detections.begin(), result.detections.end(), [](const Detection &a, const Detection &b) {
+        return a.score > b.score || (a.score == b.score && a < b);
+    });
+    result.coverage = total > 0 ? (double_t) evaluated / total : 1.0;
+    result.complete = evaluated == total;
+    return result;
+}
+
+size_t Detector::maxScale(size_t width, size_t height, size_t max_scale) const {
+    size_t fit = std::min(width, height) / _size;
+    return (max_scale == 0 || max_scale > fit) ? fit : max_scale;
+}
+
+size_t Detector::scanTile(size_t s, size_t step, size_t entry, size_t lanes) const {
+    size_t stride = s * step * lanes, tile = _tile;
+
+    if (tile == 0) {
+        // Features of a tile of corners read a (tile + ws) x (tile + ws) region of the integral image
+        auto side = (size_t) std::sqrt((double_t) DETECTOR_DEFAULT_CACHE / entry);
+        tile = side > s * _size ? side - s * _size : 0;
+    }
+    return std::max(stride, tile / stride * stride);
+}
+
+template<typename I>
+void Detector::scan(const I &img, size_t x1, size_t y1, size_t x2, size_t y2, size_t dx, size_t dy,
+                    size_t step, size_t s, std::vector<Detection> &detections) const {
+    size_t width = img.width(), height = img.height(), ws = s * _size, stride = s * step;
+    size_t tile = scanTile(s, step, entrySize(img), lanes(img));
+    size_t x0 = alignUp(dx + x1, stride) - dx, y0 = alignUp(dy + y1, stride) - dy;
+
+    // Corners must be in [x1, x2[ x [y1, y2[ and windows in the image
+    x2 = std::min(x2, width >= ws ? width - ws + 1 : 0);
+    y2 = std::min(y2, height >= ws ? height - ws + 1 : 0);
+
+    for (size_t tx = x0; tx < x2; tx += tile) {
+        for (size_t ty = y0; ty < y2; ty += tile) {
+            for (size_t x = tx; x < std::min(tx + tile, x2); x += stride) {
+                scanColumn(img, x, ty, std::min(ty + tile, y2), dx, dy, s, stride, detections);
+            }
+        }
+    }
+}
+
+template<typename I>
+void Detector::scanColumn(const I &img, size_t x, size_t y1, size_t y2, size_t dx, size_t dy, size_t s,
+                          size_t stride, std::vector<Detection> &detections) const {
+    size_t ws = s * _size;
+    double_t score;
+
+    for (size_t y = y1; y < y2; y += stride) {
+        score = (*this)(img, x, y, s);
+        if (score >= _theta)
+            detections.push_back({dx + x, dy + y, ws, ws, score});
+    }
+}
+
+void Detector::scanColumn(const IBand &img, size_t x, size_t y1, size_t y2, size_t dx, size_t dy, size_t s,
+                          size_t stride, std::vector<Detection> &detections) const {
+    size_t ws = s * _size;
+    double_t scores[P_HAAR_LANES];
+
+    for (size_t y = y1; y < y2; y += P_HAAR_LANES * stride) {
+        // The last lanes may be past the end of the column
+        size_t n = std::min<size_t>(P_HAAR_LANES, (y2 - y + stride - 1) / stride);
+        uint32_t found = (*this)(img, x, y, s, stride, (uint32_t) ((1ul << n) - 1), scores);
+        for (size_t k = 0; k < n; ++k) {
+            if (found >> k & 1)
+                detections.push_back({dx + x, dy + y + k * stride, ws, ws, scores[k]});
+        }
+    }
+}
+
+template
+double_t Detector::operator()(const IMatrix &img, size_t x, size_t y, size_t s) const;
+
+template
+double_t Detector::operator()(const IBand &img, size_t x, size_t y, size_t s) const;
@@ -0,0 +1,214 @@
+//
+// Created by bendou on 25/01/19.
+//
+
+#ifndef FACEDETECTION_DETECTOR_H
+#define FACEDETECTION_DETECTOR_H
+
+#include <chrono>
+#include "WClassifier.h"
+#include "IBand.h"
+
+#define DETECTOR_DEFAULT_THETA 0.5
+#define DETECTOR_DEFAULT_STEP 1
+#define DETECTOR_DEFAULT_BUDGET (64 * 1024 * 1024)
+
+// Number of (w + 1) x (h + 1) pixel buffers alive while a tile is cropped and integrated
+#define DETECTOR_TILE_FOOTPRINT 6
+
+// Size in bytes of the cache the integral image rows read by a tile of windows should fit in
+#define DETECTOR_DEFAULT_CACHE (256 * 1024)
+
+// Number of refinement levels of anytime detection, the coarsest stride is 2^(levels - 1) times the finest
+#define DETECTOR_ANYTIME_LEVELS 4
+
+// Number of windows evaluated between two reads of the clock
+#define DETECTOR_ANYTIME_CHECK 16
+
+/**
+ * @brief Window of an image in which an object has been detected.
+ * @details (x, y) is the upper left corner and score the normalized vote of the detector in [0, 1].
+ */
+struct Detection {
+    size_t x, y, w, h;
+    double_t score;
+};
+
+/**
+ * @brief Order of a sliding window scan : by scale, than by position.
+ */
+inline bool operator<(const Detection &a, const Detection &b) {
+    return a.w != b.w ? a.w < b.w : (a.x != b.x ? a.x < b.x : a.y < b.y);
+}
+
+/**
+ * @brief Result of a time budgeted detection.
+ * @details coverage is the ratio of the windows of a full detection that have been evaluated, complete is true if
+ *          all of them have been evaluated before the deadline.
+ */
+struct AnytimeResult {
+    std::vector<Detection> detections;
+    double_t coverage;
+    bool complete;
+};
+
+/**
+ * @class          : Detector
+ * @brief          : Strong classifier made of weighted weak classifiers \f$ \sum_t \alpha_t h_t \geq \theta \sum_t \alpha_t \f$.
+ *                   The features of the weak classifiers are given relative to a size x size window which
+ *                   is slid along the image at multiple integer scales.
+ */
+class Detector {
+
+public:
+
+    /**
+     * @brief Provides the (x, y, w, h) region of a source image as a stand alone image.
+     */
+    typedef std::function<IMatrix(size_t, size_t, size_t, size_t)> TileSource;
+
+    /**
+     * @brief Fills the next row of a streamed image, returns false when the stream is over.
+     */
+    typedef std::function<bool(vec_pix_t &)> RowSource;
+
+    typedef std::function<void(const Detection &)> DetectionSink;
+
+    explicit Detector(const std::vector<WClassifier> &h = {},
+                      const vec_t &alpha = vec_t(),
+                      size_t size = P_HAAR_FEATURE_DEFAULT_SIZE,
+                      double_t theta = DETECTOR_DEFAULT_THETA);
+
+    inline size_t size() const {return _size;}
+
+    inline size_t tile() const {return _tile;}
+
+    /**
+     * @brief Sets the side of the square tiles in which the corners of the windows are scanned.
+     * @details Windows are evaluated tile after tile so that the integral image rows read by the features stay
+     *          in cache. If tile is 0, the side is computed for each scale such as the part of the integral image
+     *          read by a tile fits in DETECTOR_DEFAULT_CACHE bytes. MAX_SIZE gives a row-major scan, which is the
+     *          default since tiles didn't give a gain above the run-to-run noise of DetectorBench.
+     */
+    inline Detector &setTile(size_t tile) {_tile = tile; return *this;}
+
+    /**
+     * @brief Score of the window at (x, y) scaled by s on an integral image, either an IMatrix or an IBand.
+     * @details Evaluation stops as soon as the remaining weights can't bring the score above threshold.
+     */
+    template<typename I>
+    double_t operator()(const I &img, size_t x, size_t y, size_t s = 1) const;
+
+    /**
+     * @brief Scores of the P_HAAR_LANES windows at (x, y + k * stride) scaled by s for the lanes k set in mask.
+     * @details Each feature is computed on all the windows at once. A window is removed from the mask as soon as it
+     *          can't reach threshold, so that the evaluation stops when all of them are rejected. Scores are the
+     *          same as the ones of the previous operator.
+     * @return Mask of the windows whose score is above threshold.
+     */
+    uint32_t operator()(const IBand &img, size_t x, size_t y, size_t s, size_t stride, uint32_t mask,
+                        double_t *scores) const;
+
+    /**
+     * @brief Slides the window along the whole image with a stride of step * s at each scale s <= max_scale.
+     * @details If max_scale is 0 the biggest scale fitting in the image is taken.
+     */
+    std::vector<Detection> detect(const IMatrix &img, size_t step = DETECTOR_DEFAULT_STEP, size_t max_scale = 0) const;
+
+    /**
+     * @brief Same detection than detect() made on overlapping tiles processed in parallel.
+     * @details Each tile has its own integral image and owns the windows whose corner lies in its core, so windows
+     *          on seams are evaluated once. The tile size and the number of threads are chosen such as
+     *          the tiles in flight never take more than budget bytes.
+     *
+     *          A tile holds whole windows, so the budget also bounds the window size : scales whose windows don't
+     *          fit in a single tile of budget bytes are not scanned, even when max_scale is 0.
+     * @throw std::invalid_argument if the budget can't hold a tile with a window of scale 1.
+     */
+    std::vector<Detection> detectTiled(const IMatrix &img, size_t budget = DETECTOR_DEFAULT_BUDGET,
+                                       size_t step = DETECTOR_DEFAULT_STEP, size_t max_scale = 0,
+                                       size_t threads = 0) const;
+
+    /**
+     * @brief Tiled detection on a width x height image whose regions are provided by source.
+     * @details Only the tiles are decoded, which allows to process images that don't fit in memory.
+     */
+    std::vector<Detection> detectTiled(size_t width, size_t height, const TileSource &source,
+                                       size_t budget = DETECTOR_DEFAULT_BUDGET,
+                                       size_t step = DETECTOR_DEFAULT_STEP, size_t max_scale = 0,
+                                       size_t threads = 0) const;
+
+    /**
+     * @brief Detection on the windows completed by the last row pushed in band.
+     * @details Scales are bounded by the number of rows kept by the band.
+     */
+    std::vector<Detection> detect(const IBand &band, size_t step = DETECTOR_DEFAULT_STEP, size_t max_scale = 0) const;
+
+    /**
+     * @brief Streams the rows of length height given by source through a band and gives detections to sink as
+     *        soon as the windows are complete.
+     * @details Only the last size() x max_scale rows are kept in memory. Detections are the same than detect() on
+     *          the whole image, ordered by last row.
+     */
+    void detectStream(size_t height, const RowSource &source, const DetectionSink &sink,
+                      size_t step = DETECTOR_DEFAULT_STEP, size_t max_scale = 0) const;
+
+    /**
+     * @brief Detection which stops at deadline and returns the detections found so far, best score first.
+     * @details The search goes coarse to fine. Each level halves the stride of the previous one and only evaluates
+     *          the new windows, from the biggest scale to the smallest. When the estimated cost of a level exceeds the
+     *          time left, the time is shared between the scales according to their number of windows. The windows a
+     *          scale didn't reach in its share are evaluated before the next level starts, so that a window is only
+     *          evaluated once all the windows of the coarser levels are. Once complete, the detections are the same
+     *          than detect().
+     */
+    AnytimeResult detectAnytime(const IMatrix &img, std::chrono::steady_clock::time_point deadline,
+                                size_t step = DETECTOR_DEFAULT_STEP, size_t max_scale = 0) const;
+
+protected:
+
+    size_t maxScale(size_t width, size_t height, size_t max_scale) const;
+
+    /**
+     * @return Side of the tiles of corners at scale s for an integral image with entries of the given size.
+     * @details The side is a multiple of the number of windows evaluated at once along y.
+     */
+    size_t scanTile(size_t s, size_t step, size_t entry, size_t lanes) const;
+
+    /**
+     * @brief Evaluates the windows of img scaled by s whose upper left corner is in [x1, x2[ x [y1, y2[.
+     * @details img is located at (dx, dy) in the scanned image. Corners are aligned on a step * s grid of the scanned
+     *          image and detections are given in its coordinates.
+     */
+    template<typename I>
+    void scan(const I &img, size_t x1, size_t y1, size_t x2, size_t y2, size_t dx, size_t dy,
+              size_t step, size_t s, std::vector<Detection> &detections) const;
+
+    /**
+     * @brief Evaluates the windows of a scan at abscissa x with corners in [y1, y2[, the same way as scan().
+     */
+    template<typename I>
+    void scanColumn(const I &img, size_t x, size_t y1, size_t y2, size_t dx, size_t dy, size_t s, size_t stride,
+                    std::vector<Detection> &detections) const;
+
+    /**
+     * @brief Same as previous scanColumn() evaluating P_HAAR_LANES windows at once.
+     */
+    void scanColumn(const IBand &img, size_t x, size_t y1, size_t y2, size_t dx, size_t dy, size_t s, size_t stride,
+                    std::vector<Detection> &detections) const;
+
+    std::vector<WClassifier> _h;
+
+    vec_t _alpha;
+
+    double_t _norm;
+
+    size_t _size;
+
+    double_t _theta;
+
+    size_t _tile;
+};
+
+
+#endif //FACEDETECTION_DETECTOR_H
@@ -0,0 +1,52 @@
+//
+// Created by bendou on 26/01/19.
+//
+
+#include "IBand.h"
+
+IBand::IBand(size_t height, size_t rows) : _height(height), _rows(rows), _width(0),
+                                           _line(height), _data(height * rows) {
+    assert(rows > 0);
+}
+
+IBand::IBand(const IMatrix &img) : IBand(img.height(), img.width()) {
+    for (size_t x = 0; x < img.width(); ++x) {
+        push(img.row(x));
+    }
+}
+
+IBand &IBand::push(const vec_pix_t &row) {
+    assert(row.size() == _height);
+
+    for (size_t y = 0; y < _height; ++y) {
+        _line[y] = (uint32_t) (row[y].red() + row[y].green() + row[y].blue());
+    }
+    return integrate();
+}
+
+IBand &IBand::push(const uc_t *row, size_t channels) {
+    for (size_t y = 0; y < _height; ++y) {
+        _line[y] = 0;
+        for (size_t c = 0; c < channels; ++c) {
+            _line[y] += row[channels * y + c];
+        }
+        // Grey scale pixels have the same value on the three components
+        if (channels == 1)
+            _line[y] *= 3;
+    }
+    return integrate();
+}
+
+IBand &IBand::integrate() {
+    uint32_t *dst = &_data[(_width % _rows) * _height];
+    const uint32_t *prev = _width > 0 ? data(_width - 1) : nullptr;
+    uint32_t sum = 0;
+
+    // Computing integral image using recurrence formula, the previous row is overwritten if the band has one row
+    for (size_t y = 0; y < _height; ++y) {
+        sum += _line[y];
+        dst[y] = (prev != nullptr ? prev[y] : 0) + sum;
+    }
+    _width++;
+    return *this;
+}
@@ -0,0 +1,102 @@
+//
+// Created by bendou on 26/01/19.
+//
+
+#ifndef FACEDETECTION_IBAND_H
+#define FACEDETECTION_IBAND_H
+
+#include <cstdint>
+#include <IMatrix.h>
+
+/**
+ * @class          : IBand
+ * @brief          : Integral image of a stream of image rows which only keeps the last rows.
+ *                   Rows are pushed one by one, typically from a decoder or a line scan camera, and are stored
+ *                   in a ring of `rows` integral rows. Memory is O(height x rows) whatever the number of pushed rows.
+ *
+ *                   The integral stores the sum of red, green and blue components as 32 bits words wrapping
+ *                   around. Rectangle sums are exact as long as they are lower than 2^31 (about 2.8M pixels).
+ *
+ *                   The x/y notations are the same than IMatrix : a row is the set of pixels with the same x.
+ */
+class IBand {
+
+public:
+
+    /**
+     * @brief Construct an empty band of rows of length height keeping the last rows rows.
+     */
+    IBand(size_t height, size_t rows);
+
+    /**
+     * @brief Construct a band holding the integral of the whole image.
+     */
+    explicit IBand(const IMatrix &img);
+
+    // GETTERS
+
+    /**
+     * @return Number of rows pushed so far.
+     */
+    inline size_t width() const {return _width;}
+
+    inline size_t height() const {return _height;}
+
+    inline size_t rows() const {return _rows;}
+
+    /**
+     * @return First row still in the band.
+     */
+    inline size_t first() const {return _width > _rows ? _width - _rows : 0;}
+
+    /**
+     * @return Integral image value at (x, y) modulo 2^32.
+     */
+    inline uint32_t operator()(size_t x, size_t y) const {
+        assert(x >= first() && x < _width && y < _height);
+        return _data[(x % _rows) * _height + y];
+    }
+
+    /**
+     * @brief Pointer to the y-contiguous integral values of row x.
+     */
+    inline const uint32_t *data(size_t x) const {return &_data[(x % _rows) * _height];}
+
+    // MANIPULATORS
+
+    /**
+     * @brief Integrates the row x = width() and drops the oldest row if the band is full.
+     */
+    IBand &push(const vec_pix_t &row);
+
+    /**
+     * @brief Same as previous push but reading a decoder scanline of height pixels of channels components.
+     */
+    IBand &push(const uc_t *row, size_t channels = 1);
+
+    /**
+     * @brief Sum of pixels values within the rectangle, the same way as IMatrix::sum().
+     * @details The value is the sum of the red, green and blue components. x1 and x2 must be in the band.
+     */
+    inline long sum(size_t x1, size_t y1, size_t x2, size_t y2) const {
+        return (int32_t) ((*this)(x1, y1) + (*this)(x2, y2) - (*this)(x1, y2) - (*this)(x2, y1));
+    }
+
+private:
+
+    IBand &integrate();
+
+    size_t _height;
+
+    size_t _rows;
+
+    size_t _width;
+
+    // Prefix sums of the row being pushed
+    std::vector<uint32_t> _line;
+
+    std::vector<uint32_t> _data;
+};
+
+
+#endif //FACEDETECTION_IBAND_H
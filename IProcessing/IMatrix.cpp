@@ -4,6 +4,7 @@
 
 #define STB_IMAGE_IMPLEMENTATION
 
+#include <stdexcept>
 #include "IMatrix.h"
 
 
@@ -19,6 +20,27 @@ IMatrix::IMatrix(const IMatrix &img) : NPMatrix(img),
 }
 
 
+IMatrix::IMatrix(IMatrix &&img) noexcept : NPMatrix(std::move(img)),
+                                          _format(img._format),
+                                          _limited(img._limited),
+                                          _intgr(std::move(img._intgr)) {}
+
+IMatrix &IMatrix::operator=(IMatrix &&img) noexcept {
+    if (this == &img)
+        return *this;
+
+    // The integral image of img only describes this image when all of its storage is taken
+    bool whole = hasDefaultBrowseIndices() && img.hasDefaultBrowseIndices();
+
+    mat_pix_t::operator=(std::move(img));
+    if (whole) {
+        _intgr = std::move(img._intgr);
+    } else {
+        _intgr.reset(nullptr);
+    }
+    return *this;
+}
+
 IMatrix::IMatrix(const std::string &path, Pixel::Format format, bool limited)
         : NPMatrix(), _format(format), _intgr(nullptr) {
     read(path, format);
@@ -38,13 +60,22 @@ IMatrix::IMatrix(const mat_pix_t &m, bool limited) : NPMatrix(m),
     copy(m);
 }
 
+IMatrix::IMatrix(mat_pix_t &&m, bool limited) : NPMatrix(std::move(m)),
+                                                _format(Pixel::GScale),
+                                                _limited(limited),
+                                                _intgr(nullptr) {
+    if (!empty())
+        _format = (*this)(0, 0).format();
+}
+
 // FILE ACCESS
 
 void IMatrix::read(const std::string &path, Pixel::Format format) {
     int x, y, n, channels_format = format == Pixel::GScale ? 1 : 3;
     stbi_uc *result = stbi_load(path.c_str(), &x, &y, &n, channels_format);
 
-    assert(result != nullptr);
+    if (result == nullptr)
+        throw std::runtime_error("cannot read " + path + " : " + stbi_failure_reason());
 
     // Creates a matrix with the read image, x is the length and y the width, n is the number of channels
     mat_pix_t read_mat = mat_pix_t((size_t) x, (size_t) y);
@@ -58,7 +89,7 @@ void IMatrix::read(const std::string &path, Pixel::Format format) {
                 read_mat(i, j) = Pixel(result[base], _limited);
         }
     }
-    copy(read_mat);
+    mat_pix_t::operator=(std::move(read_mat));
     delete[] result;
 }
 
@@ -80,7 +111,7 @@ mat_pix_t & IMatrix::intgr() const {
             img(x, y) = img(x - 1, y) + sum(x, y);
         }
     }
-    _intgr.reset(new mat_pix_t(img(1, 1, width(), height())));
+    _intgr.reset(new mat_pix_t(std::move(img(1, 1, width(), height()))));
     return *_intgr;
 }
 
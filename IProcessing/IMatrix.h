@@ -32,12 +32,24 @@ public:
 
     IMatrix(const IMatrix &img);
 
+    /**
+     *
+     * @brief Construct an image by taking the pixels and the integral image of img
+     */
+    IMatrix(IMatrix &&img) noexcept;
+
     /**
      *
      * @brief Construct by copy a new image matrix with given matrix m
      */
     IMatrix(const mat_pix_t &m, bool limited = false);
 
+    /**
+     *
+     * @brief Construct an image by taking the pixels of matrix m
+     */
+    IMatrix(mat_pix_t &&m, bool limited = false);
+
     /**
      *
      * @brief Construct zero image with given width and height
@@ -63,6 +75,7 @@ public:
      * @brief   Uses std_image.h to read an image at path location. The IMatrix object is set to the ridden image
      *          after function call.
      * @param path string of relative path of the image
+     * @throw std::runtime_error if the file is missing or can't be decoded
      */
     void read(const std::string &path, Pixel::Format format = Pixel::GScale);
 
@@ -104,6 +117,13 @@ public:
         return *this;
     }
 
+    /**
+     *
+     * @brief Take the pixels of img, and its integral image when both images are whole.
+     *        Moving into a browsed image copies the pixels into the sub-range and resets the integral image.
+     */
+    IMatrix &operator=(IMatrix &&img) noexcept;
+
 private:
 
     void intgrCopy(const IMatrix& img);
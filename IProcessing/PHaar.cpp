@@ -3,9 +3,28 @@
 //
 
 #include "PHaar.h"
+#include "IBand.h"
 
-double_t PHaar::operator()(const IMatrix &img) const {
-    Pixel f;
+// AVX2 lanes are compiled for the build target, or on their own and chosen at run time when the CPU supports them
+#if !defined(__AVX512F__) && !defined(__AVX2__) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define P_HAAR_DISPATCH
+#define P_HAAR_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define P_HAAR_AVX2
+#endif
+
+#if defined(__AVX512F__) || defined(P_HAAR_AVX2)
+#include <immintrin.h>
+#endif
+
+// Grey value of a combination of sums, IBand sums are the sum of the 3 components
+static inline double_t grey(const Pixel &p) { return p.grey(); }
+
+static inline double_t grey(long s) { return s / 3; }
+
+template<typename I>
+double_t PHaar::operator()(const I &img) const {
+    decltype(img.sum(0, 0, 0, 0)) f{};
     switch (type) {
         case TwoRectW:
             f = img.sum(x, y, x + w / 2 - 1, y + h - 1) -
@@ -28,5 +47,197 @@ double_t PHaar::operator()(const IMatrix &img) const {
             break;
     }
 
-    return f.grey();
-}
\ No newline at end of file
+    return grey(f);
+}
+
+// Lanes of 32 bits integral values, wrapping around as the IBand entries. Operations write their first operand,
+// vector registers are never passed by value so that the AVX2 lanes can be compiled apart from the rest of the file
+
+struct PLanes {
+    struct type {
+        uint32_t v[8];
+    };
+
+    static const size_t size = 8;
+
+    static inline void load(type &a, const uint32_t *p, size_t stride, uint32_t mask) {
+        for (size_t k = 0; k < size; ++k) {
+            a.v[k] = (mask >> k & 1) ? p[k * stride] : 0;
+        }
+    }
+
+    static inline void add(type &a, const type &b) {
+        for (size_t k = 0; k < size; ++k) {
+            a.v[k] += b.v[k];
+        }
+    }
+
+    static inline void sub(type &a, const type &b) {
+        for (size_t k = 0; k < size; ++k) {
+            a.v[k] -= b.v[k];
+        }
+    }
+
+    static inline void store(int32_t *dst, const type &a) {
+        for (size_t k = 0; k < size; ++k) {
+            dst[k] = (int32_t) a.v[k];
+        }
+    }
+};
+
+#if defined(P_HAAR_AVX2)
+
+struct PLanesAvx2 {
+    typedef __m256i type;
+
+    static const size_t size = 8;
+
+    P_HAAR_AVX2 static inline void load(type &a, const uint32_t *p, size_t stride, uint32_t mask) {
+        // Lane k is read if its sign bit is set
+        __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        __m256i m = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int) mask), bits), bits);
+        if (stride == 1) {
+            a = _mm256_maskload_epi32((const int *) p, m);
+            return;
+        }
+        __m256i index = _mm256_mullo_epi32(_mm256_set1_epi32((int) stride), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        a = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int *) p, index, m, 4);
+    }
+
+    P_HAAR_AVX2 static inline void add(type &a, const type &b) { a = _mm256_add_epi32(a, b); }
+
+    P_HAAR_AVX2 static inline void sub(type &a, const type &b) { a = _mm256_sub_epi32(a, b); }
+
+    P_HAAR_AVX2 static inline void store(int32_t *dst, const type &a) { _mm256_storeu_si256((__m256i *) dst, a); }
+};
+
+#endif
+
+#if defined(__AVX512F__)
+
+struct PLanesAvx512 {
+    typedef __m512i type;
+
+    static const size_t size = 16;
+
+    static inline void load(type &a, const uint32_t *p, size_t stride, uint32_t mask) {
+        if (stride == 1) {
+            a = _mm512_maskz_loadu_epi32((__mmask16) mask, p);
+            return;
+        }
+        __m512i index = _mm512_mullo_epi32(_mm512_set1_epi32((int) stride),
+                                           _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+        a = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), (__mmask16) mask, index, p, 4);
+    }
+
+    static inline void add(type &a, const type &b) { a = _mm512_add_epi32(a, b); }
+
+    static inline void sub(type &a, const type &b) { a = _mm512_sub_epi32(a, b); }
+
+    static inline void store(int32_t *dst, const type &a) { _mm512_storeu_si512(dst, a); }
+};
+
+#endif
+
+// Rectangle sums of the lanes, the same way as IBand::sum()
+template<typename L>
+static inline void sum(const IBand &img, size_t x1, size_t y1, size_t x2, size_t y2, size_t stride, uint32_t mask,
+                       typename L::type &s) {
+    const uint32_t *r1 = img.data(x1), *r2 = img.data(x2);
+    typename L::type t;
+
+    L::load(s, r1 + y1, stride, mask);
+    L::load(t, r2 + y2, stride, mask);
+    L::add(s, t);
+    L::load(t, r1 + y2, stride, mask);
+    L::sub(s, t);
+    L::load(t, r2 + y1, stride, mask);
+    L::sub(s, t);
+}
+
+template<typename L>
+static inline void featureLanes(const PHaar &f, const IBand &img, size_t stride, uint32_t mask, int32_t *sums) {
+    static_assert(L::size == P_HAAR_LANES, "one lane per window");
+
+    const size_t x = f.x, y = f.y, w = f.w, h = f.h;
+    typename L::type a{}, b;
+
+    switch (f.type) {
+        case PHaar::TwoRectW:
+            sum<L>(img, x, y, x + w / 2 - 1, y + h - 1, stride, mask, a);
+            sum<L>(img, x + w / 2, y, x + w - 1, y + h - 1, stride, mask, b);
+            L::sub(a, b);
+            break;
+        case PHaar::TwoRectH:
+            sum<L>(img, x, y + h / 2 - 1, x + w - 1, y + h - 1, stride, mask, a);
+            sum<L>(img, x, y, x + w - 1, y + h / 2, stride, mask, b);
+            L::sub(a, b);
+            break;
+        case PHaar::ThreeRect:
+            sum<L>(img, x, y, x + w / 3 - 1, y + h - 1, stride, mask, a);
+            sum<L>(img, x + w / 3, y, x + 2 * w / 3 - 1, y + h - 1, stride, mask, b);
+            L::sub(a, b);
+            sum<L>(img, x + 2 * w / 3, y, x + w - 1, y + h - 1, stride, mask, b);
+            L::add(a, b);
+            break;
+        case PHaar::FourRect:
+            sum<L>(img, x, y, x + w / 2 - 1, y + h / 2 - 1, stride, mask, a);
+            sum<L>(img, x + w / 2, y, x + w - 1, y + h / 2 - 1, stride, mask, b);
+            L::sub(a, b);
+            sum<L>(img, x, y + h / 2, x + w / 2 - 1, y + h - 1, stride, mask, b);
+            L::sub(a, b);
+            sum<L>(img, x + w / 2, y + h / 2, x + w - 1, y + h - 1, stride, mask, b);
+            L::add(a, b);
+            break;
+    }
+    L::store(sums, a);
+}
+
+#if defined(P_HAAR_DISPATCH)
+
+// Everything called is inlined, so that the AVX2 lanes are compiled in a single AVX2 function
+__attribute__((target("avx2"), flatten))
+static void lanesAvx2(const PHaar &f, const IBand &img, size_t stride, uint32_t mask, int32_t *sums) {
+    featureLanes<PLanesAvx2>(f, img, stride, mask, sums);
+}
+
+static bool hasAvx2() {
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return avx2;
+}
+
+#endif
+
+void PHaar::lanes(const IBand &img, size_t stride, uint32_t mask, int32_t *sums) const {
+#if defined(__AVX512F__)
+    featureLanes<PLanesAvx512>(*this, img, stride, mask, sums);
+#elif defined(P_HAAR_DISPATCH)
+    if (hasAvx2()) {
+        lanesAvx2(*this, img, stride, mask, sums);
+    } else {
+        featureLanes<PLanes>(*this, img, stride, mask, sums);
+    }
+#elif defined(P_HAAR_AVX2)
+    featureLanes<PLanesAvx2>(*this, img, stride, mask, sums);
+#else
+    featureLanes<PLanes>(*this, img, stride, mask, sums);
+#endif
+}
+
+const char *PHaar::instructions() {
+#if defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(P_HAAR_DISPATCH)
+    return hasAvx2() ? "AVX2" : "scalar";
+#elif defined(P_HAAR_AVX2)
+    return "AVX2";
+#else
+    return "scalar";
+#endif
+}
+
+template
+double_t PHaar::operator()(const IMatrix &img) const;
+
+template
+double_t PHaar::operator()(const IBand &img) const;
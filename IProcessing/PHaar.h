@@ -9,6 +9,15 @@
 
 #define P_HAAR_FEATURE_DEFAULT_SIZE 24
 
+// Number of adjacent windows whose features are computed at once, one per 32 bits lane of the vector registers
+#if defined(__AVX512F__)
+#define P_HAAR_LANES 16
+#else
+#define P_HAAR_LANES 8
+#endif
+
+class IBand;
+
 
 class PHaar {
 
@@ -31,7 +40,30 @@ public:
 
     inline PHaar& scale(size_t sw, size_t sy) {w *= sw; h *= sy; return *this;}
 
-    double_t operator()(const IMatrix &img) const;
+    /**
+     * @brief Feature of a detection window whose upper left corner is (x0, y0) and scaled by s.
+     * @details The coordinates of this feature are taken relative to the window.
+     */
+    inline PHaar placed(size_t x0, size_t y0, size_t s) const {return PHaar(x0 + s * x, y0 + s * y, s * w, s * h, type);}
+
+    /**
+     * @brief Value of the feature computed on an integral image, either an IMatrix or an IBand.
+     */
+    template<typename I>
+    double_t operator()(const I &img) const;
+
+    /**
+     * @brief Computes the feature for the P_HAAR_LANES windows shifted by k * stride along y at once.
+     * @details Lane k holds the sum of the three components of the feature shifted by k * stride, its value is
+     *          sums[k] / 3. Only the lanes set in mask are read from img, the others are 0. Uses AVX-512 when
+     *          built for it, AVX2 when the CPU supports it and contiguous loads when stride is 1.
+     */
+    void lanes(const IBand &img, size_t stride, uint32_t mask, int32_t *sums) const;
+
+    /**
+     * @return Instructions used by lanes(), "AVX-512", "AVX2" or "scalar".
+     */
+    static const char *instructions();
 
     size_t x, y, w, h;
     Type type;
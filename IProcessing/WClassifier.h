@@ -17,7 +17,9 @@ public:
     WClassifier(const PHaar &f0, double_t theta0 = W_CLASSIFIER_DEFAULT_THETA, bool pol0 = W_CLASSIFIER_DEFAULT_POL) :
             f(f0), _theta(theta0), _pol(pol0) {}
 
-    inline bool operator()(const IMatrix& img) {return _pol ? f(img) < _theta :  f(img) > _theta;}
+    inline bool operator()(const IMatrix& img) {return classify(f(img));}
+
+    inline bool classify(double_t value) const {return _pol ? value < _theta : value > _theta;}
 
     double_t train(const vec_t &w, const std::vector<IMatrix> &x, const std::vector<bool> &y);
 
@@ -93,7 +93,9 @@
 
 #include <NVector.h>
 #include <NPMatrix.h>
+#include <NFixed.h>
 #include <Vector3.h>
+#include <Vector3Batch.h>
 #include <Pixel.h>
 #include <AESByte.h>
 #include <thirdparty.h>
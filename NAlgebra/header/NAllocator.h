@@ -0,0 +1,170 @@
+//
+// Created by bendou on 04/02/19.
+//
+
+#ifndef MATHTOOLKIT_NALLOCATOR_H
+#define MATHTOOLKIT_NALLOCATOR_H
+
+#include "thirdparty.h"
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+// Alignment of the components of vectors, matrices and scratch buffers, size of a cache line
+#define NALLOCATOR_ALIGNMENT 64
+
+// Size in bytes of the blocks reserved by arenas, larger buffers get a block of their own
+#define NARENA_BLOCK (1 << 16)
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   NAllocator
+ * @date    04/02/2019
+ * @author  samiBendou
+ * @brief   Allocator of arrays aligned on `NALLOCATOR_ALIGNMENT` bytes.
+ *
+ * @details Arrays start on a cache line, so that the registers of the vectorized kernels are loaded without crossing
+ *          cache lines. The allocator has no state, arrays allocated by any instance can be released by any other.
+ *          It allocates the arrays of `NStorage<T>` which are too long to be stored inline.
+ */
+template<typename T>
+class NAllocator {
+
+public:
+
+    typedef T value_type;
+
+    NAllocator() = default;
+
+    template<typename U>
+    NAllocator(const NAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        void *p = nullptr;
+#ifdef _WIN32
+        p = _aligned_malloc(n * sizeof(T), NALLOCATOR_ALIGNMENT);
+        if (p == nullptr)
+            throw std::bad_alloc();
+#else
+        if (posix_memalign(&p, NALLOCATOR_ALIGNMENT, n * sizeof(T)) != 0)
+            throw std::bad_alloc();
+#endif
+        return static_cast<T *>(p);
+    }
+
+    void deallocate(T *p, size_t) {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+
+    template<typename U>
+    inline bool operator==(const NAllocator<U> &) const { return true; }
+
+    template<typename U>
+    inline bool operator!=(const NAllocator<U> &) const { return false; }
+};
+
+/** @} */
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   NArena
+ * @date    04/02/2019
+ * @author  samiBendou
+ * @brief   Bump allocator of the scratch buffers of the algorithms.
+ *
+ * @details Each thread has its own arena, made of blocks of `NARENA_BLOCK` bytes which are kept from a call to
+ *          another. Buffers are taken with a `NArena::Scope` and are all released at once when the scope ends, the
+ *          next scopes reusing the same memory. Algorithms called repeatedly on small matrices then don't allocate
+ *          once the blocks are reserved. Larger blocks, taken by buffers of more than `NARENA_BLOCK` bytes, are freed
+ *          when the outermost scope of the thread ends.
+ *
+ *          @code{.cpp}
+ *          NArena::Scope scratch;
+ *          double_t *x = scratch.alloc<double_t>(n); // x is valid until the end of the scope
+ *          @endcode
+ *
+ *          Buffers are aligned on `NALLOCATOR_ALIGNMENT` bytes and value initialized. Their components are not
+ *          destroyed, they must have a trivial destructor. Scopes are nested the usual way, a buffer must not outlive
+ *          the scope that took it.
+ */
+class NArena {
+
+public:
+
+    class Scope {
+
+    public:
+
+        Scope();
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope();
+
+        /**
+         * @return Array of n value initialized components, valid until the end of the scope.
+         */
+        template<typename T>
+        T *alloc(size_t n) {
+            static_assert(std::is_trivially_destructible<T>::value, "arena components are never destroyed");
+            T *p = static_cast<T *>(_arena.reserve(n * sizeof(T)));
+            std::uninitialized_fill_n(p, n, T());
+            return p;
+        }
+
+    private:
+
+        NArena &_arena;
+
+        size_t _block;
+
+        size_t _offset;
+    };
+
+    NArena() = default;
+
+    NArena(const NArena &) = delete;
+
+    NArena &operator=(const NArena &) = delete;
+
+    ~NArena();
+
+    /**
+     * @return Arena of the calling thread.
+     */
+    static NArena &local();
+
+    /**
+     * @return Number of bytes reserved by the blocks of the arena.
+     */
+    size_t capacity() const;
+
+protected:
+
+    // Aligned memory of size bytes taken from the current block, or from the next one large enough
+    void *reserve(size_t bytes);
+
+    // Frees the blocks larger than NARENA_BLOCK, called when no scope is open
+    void trim();
+
+    std::vector<std::pair<char *, size_t>> _blocks;
+
+    size_t _block{0};
+
+    size_t _offset{0};
+
+    // Number of open scopes
+    size_t _depth{0};
+};
+
+/** @} */
+
+#endif //MATHTOOLKIT_NALLOCATOR_H
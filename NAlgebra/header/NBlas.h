@@ -0,0 +1,333 @@
+//
+// Created by bendou on 29/01/19.
+//
+
+#ifndef MATHTOOLKIT_NBLAS_H
+#define MATHTOOLKIT_NBLAS_H
+
+#include "thirdparty.h"
+#include "NPool.h"
+#include <cstdint>
+
+// Size of the block of C computed in registers by the micro-kernel
+#define NBLAS_MR 6
+#define NBLAS_NR 8
+
+// Number of columns of the block of C for single precision and 8-bit integers, twice as many fit in registers
+#define NBLAS_NR32 16
+
+// Size of the packed blocks of A (MC x KC, in L2 cache) and of B (KC x NC, in L3 cache)
+#define NBLAS_MC 96
+#define NBLAS_KC 256
+#define NBLAS_NC 2048
+
+// Number of multiply-adds below which the product is made without packing
+#define NBLAS_GEMM_MIN (32 * 32 * 32)
+
+// Number of multiply-adds below which the products are made by the calling thread only
+#define NBLAS_PARALLEL_MIN (96 * 96 * 96)
+#define NBLAS_GEMV_PARALLEL_MIN (256 * 256)
+
+// Number of rows of the matrix vector product computed by a task
+#define NBLAS_GEMV_ROWS 64
+
+// Number of components of the linear combinations computed by a task, the block of the result staying in L1 cache
+#define NBLAS_COMBINE_NB 512
+
+// Size below which blocks are transposed without being split
+#define NBLAS_TRANSPOSE_NB 32
+
+// Number of components reduced at once, the partial results of the blocks being added pairwise
+#define NBLAS_REDUCE_NB 4096
+
+// Number of components below which reductions are made by the calling thread only
+#define NBLAS_REDUCE_PARALLEL_MIN (1 << 18)
+
+// Number of small systems solved by a task, multiple of the number of lanes of the registers
+#define NBLAS_GESV_BATCH 256
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   NBlas
+ * @date    29/01/2019
+ * @author  samiBendou
+ * @brief   Dense linear algebra kernels on row-major arrays of `double_t`, `float` and 8-bit integers.
+ *
+ * @details The kernels work on raw sub-arrays given by a pointer to their first element and their leading dimension,
+ *          the distance between two rows. Matrix products also take column-major operands, given by the distances
+ *          between two rows and two columns. They are used by `NPMatrix<double_t>` and `NPMatrix<float>` on their
+ *          sub-matrices.
+ *
+ *          @section GEMM Matrix product
+ *
+ *          The product is blocked the usual way : \f$ B \f$ is packed by blocks of `NBLAS_KC` x `NBLAS_NC` and
+ *          \f$ A \f$ by blocks of `NBLAS_MC` x `NBLAS_KC`, so that they are read contiguously from cache. The packed
+ *          blocks are then multiplied by a micro-kernel that keeps a `NBLAS_MR` x `NBLAS_NR` block of \f$ C \f$
+ *          in registers. The micro-kernel uses AVX2 and FMA instructions when they are available.
+ *
+ *          Single precision uses the same blocks with `NBLAS_NR32` columns, a register holding 8 components instead of 4,
+ *          so that it runs twice as many operations per instruction.
+ *
+ *          @section Integer 8-bit integer product
+ *
+ *          Products of quantized matrices take `int8_t` or `uint8_t` components for \f$ A \f$ and `int8_t` components for
+ *          \f$ B \f$ and accumulate them exactly in `int32_t`. The blocks are packed as 16-bit integers, by pairs of
+ *          consecutive columns of \f$ A \f$ and rows of \f$ B \f$. The micro-kernel multiplies the pairs and adds
+ *          the two products to the 32-bit lanes of the accumulators in a single instruction. Floating point matrices
+ *          are converted to and from 8-bit integers with `quantize` and `dequantize`. The sums are exact as long as k
+ *          stays below the bound given by each overload, \f$ 2^{17} \f$ for signed A and 65793 for unsigned A.
+ *
+ *          @section Rows Row operations
+ *
+ *          Gauss elimination and triangular solves are written with `axpy`, `scal` and `swap`, which work in place on
+ *          contiguous rows without allocating.
+ *
+ *          @section Parallel Parallel products
+ *
+ *          Large products are shared between the threads of `NPool::instance()`. The matrix product gives each thread
+ *          blocks of rows of \f$ C \f$ and the matrix vector product ranges of rows of \f$ A \f$. Each component of
+ *          the result is computed by a single thread in a fixed order, so that results don't depend on the number of
+ *          threads.
+ *
+ *          @section Reductions Reductions
+ *
+ *          Sums, dot products and extremums are computed by blocks of `NBLAS_REDUCE_NB` components, shared between
+ *          threads for large arrays. Each block is reduced with several registers of independent sums, which are added
+ *          pairwise as are the results of the blocks. The order of the operations only depends on the size of the
+ *          array, so that results are reproducible whatever the number of threads. Extremums return the index of the
+ *          first minimum and of the first maximum in a single pass.
+ *
+ *          @section Combine Linear combinations
+ *
+ *          Linear combinations of many arrays are computed by blocks of `NBLAS_COMBINE_NB` components. The block of the
+ *          result stays in registers and L1 cache while the arrays are added 4 at a time, so that the result is read
+ *          and written once per 4 arrays instead of once per array. Blocks are shared between threads for long arrays.
+ *          The transposed matrix vector product is the combination of the rows of the matrix.
+ *
+ *          @section Transpose Transposition
+ *
+ *          Matrices are transposed recursively, the largest dimension being split in halves until the blocks have
+ *          less than `NBLAS_TRANSPOSE_NB` rows and columns. Blocks then fit in cache whatever its size. They are
+ *          transposed by squares of 4 x 4 doubles or 8 x 8 floats, loaded in registers and shuffled with AVX.
+ *
+ *          @section Batch Batches of small systems
+ *
+ *          Small systems are too small to be vectorized one by one. Batches of systems are stored component by
+ *          component, so that each lane of a register holds the same component of a different system. A batch is
+ *          then solved with the scalar algorithm, each instruction working on 4 systems with AVX2.
+ */
+class NBlas {
+
+public:
+
+    /**
+     * @brief Matrix product \f$ C = C + A B \f$.
+     * @details \f$ A \f$ is n x k, \f$ B \f$ is k x p and \f$ C \f$ is n x p. C must not overlap A or B.
+     */
+    static void gemm(size_t n, size_t p, size_t k, const double_t *a, size_t lda, const double_t *b, size_t ldb,
+                     double_t *c, size_t ldc);
+
+    static void gemm(size_t n, size_t p, size_t k, const float *a, size_t lda, const float *b, size_t ldb,
+                     float *c, size_t ldc);
+
+    /**
+     * @brief Matrix product \f$ C = C + A B \f$ of matrices stored with any layout.
+     * @details The component (i, j) of A is `a[i * rsa + j * csa]` and the one of B `b[i * rsb + j * csb]`. Row-major
+     *          matrices have a column stride of 1 and column-major matrices a row stride of 1. The operands are
+     *          read in place by the packing, transposed operands are not copied.
+     */
+    static void gemm(size_t n, size_t p, size_t k, const double_t *a, size_t rsa, size_t csa,
+                     const double_t *b, size_t rsb, size_t csb, double_t *c, size_t ldc);
+
+    static void gemm(size_t n, size_t p, size_t k, const float *a, size_t rsa, size_t csa,
+                     const float *b, size_t rsb, size_t csb, float *c, size_t ldc);
+
+    /**
+     * @brief Product of 8-bit integer matrices \f$ C = C + A B \f$ accumulated in 32-bit integers.
+     * @details The sums of products must fit in `int32_t`. A product being at most \f$ 128^2 = 2^{14} \f$ in absolute
+     *          value, this holds for any components when C is 0 and \f$ k < 2^{17} \f$.
+     */
+    static void gemm(size_t n, size_t p, size_t k, const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                     int32_t *c, size_t ldc);
+
+    /**
+     * @brief Product \f$ C = C + A B \f$ of unsigned 8-bit integers by signed ones accumulated in 32-bit integers.
+     * @details The sums of products must fit in `int32_t`. A product being at least \f$ 255 \times (-128) \f$, this
+     *          holds for any components when C is 0 and \f$ k \leq 65793 \f$.
+     */
+    static void gemm(size_t n, size_t p, size_t k, const uint8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                     int32_t *c, size_t ldc);
+
+    static void gemm(size_t n, size_t p, size_t k, const int8_t *a, size_t rsa, size_t csa,
+                     const int8_t *b, size_t rsb, size_t csb, int32_t *c, size_t ldc);
+
+    static void gemm(size_t n, size_t p, size_t k, const uint8_t *a, size_t rsa, size_t csa,
+                     const int8_t *b, size_t rsb, size_t csb, int32_t *c, size_t ldc);
+
+    /**
+     * @brief Matrix vector product \f$ y = y + A x \f$.
+     * @details \f$ A \f$ is n x p, x has p components and y has n components. y must not overlap A or x.
+     */
+    static void gemv(size_t n, size_t p, const double_t *a, size_t lda, const double_t *x, double_t *y);
+
+    static void gemv(size_t n, size_t p, const float *a, size_t lda, const float *x, float *y);
+
+    /**
+     * @brief Transposed matrix vector product \f$ y = y + A^\top x \f$.
+     * @details \f$ A \f$ is n x p, x has n components and y has p components. y is the linear combination of the
+     *          rows of A by the components of x. y must not overlap A or x.
+     */
+    static void gemvT(size_t n, size_t p, const double_t *a, size_t lda, const double_t *x, double_t *y);
+
+    static void gemvT(size_t n, size_t p, const float *a, size_t lda, const float *x, float *y);
+
+    /**
+     * @brief Linear combination \f$ y = y + s_0 x_0 + ... + s_{count - 1} x_{count - 1} \f$ of arrays of n components.
+     * @details The arrays x_k can be stored anywhere. y must not overlap them.
+     */
+    static void combine(size_t n, size_t count, const double_t *const *x, const double_t *s, double_t *y);
+
+    static void combine(size_t n, size_t count, const float *const *x, const float *s, float *y);
+
+    /**
+     * @brief Solve count independent n x n systems \f$ A_s x_s = b_s \f$ by \f$ LU \f$ decomposition.
+     * @details The component (i, j) of the system s is `a[(i * n + j) * count + s]` and the component i of its second
+     *          member `b[i * count + s]`. Each system is pivoted on its own. b is replaced by the solutions and a is
+     *          overwritten. Degenerate systems have non finite solutions, without affecting the others.
+     */
+    static void gesvBatch(size_t n, size_t count, double_t *a, double_t *b);
+
+    /**
+     * @brief Row operation \f$ y = y + s x \f$ on arrays of n components.
+     */
+    static void axpy(size_t n, double_t s, const double_t *x, double_t *y);
+
+    static void axpy(size_t n, float s, const float *x, float *y);
+
+    /**
+     * @brief Row operation \f$ x = s x \f$ on an array of n components.
+     */
+    static void scal(size_t n, double_t s, double_t *x);
+
+    static void scal(size_t n, float s, float *x);
+
+    /**
+     * @brief Exchange of two arrays of n components.
+     */
+    static void swap(size_t n, double_t *x, double_t *y);
+
+    static void swap(size_t n, float *x, float *y);
+
+    /**
+     * @brief Transposition \f$ B = A^\top \f$.
+     * @details \f$ A \f$ is n x p and \f$ B \f$ is p x n. B must not overlap A.
+     */
+    static void transpose(size_t n, size_t p, const double_t *a, size_t lda, double_t *b, size_t ldb);
+
+    static void transpose(size_t n, size_t p, const float *a, size_t lda, float *b, size_t ldb);
+
+    /**
+     * @return Sum of the n components of x.
+     */
+    static double_t sum(size_t n, const double_t *x);
+
+    static float sum(size_t n, const float *x);
+
+    /**
+     * @return Dot product of two arrays of n components.
+     */
+    static double_t dot(size_t n, const double_t *x, const double_t *y);
+
+    static float dot(size_t n, const float *x, const float *y);
+
+    /**
+     * @brief Indices of the first minimum and of the first maximum of n > 0 components.
+     */
+    static void minmax(size_t n, const double_t *x, size_t &imin, size_t &imax);
+
+    static void minmax(size_t n, const float *x, size_t &imin, size_t &imax);
+
+    /**
+     * @brief Indices of the first minimum and of the first maximum of the absolute values of n > 0 components.
+     */
+    static void minmaxAbs(size_t n, const double_t *x, size_t &imin, size_t &imax);
+
+    static void minmaxAbs(size_t n, const float *x, size_t &imin, size_t &imax);
+
+    /**
+     * @brief Quantization \f$ q = round(x / s) \f$ of n components, saturated to [-127, 127].
+     * @details The scale \f$ s \f$ is usually the maximum absolute value of x divided by 127.
+     */
+    static void quantize(size_t n, const float *x, float scale, int8_t *q);
+
+    /**
+     * @brief Conversion \f$ y = s x \f$ of n accumulated products of quantized components back to `float`.
+     * @details The scale \f$ s \f$ of a product is the product of the scales of its factors.
+     */
+    static void dequantize(size_t n, const int32_t *x, float scale, float *y);
+
+protected:
+
+    /**
+     * @brief Product of matrices of any supported type, blocked and packed as described above.
+     */
+    template<typename TA, typename TB, typename C>
+    static void gemmBlocked(size_t n, size_t p, size_t k, const TA *a, size_t rsa, size_t csa,
+                            const TB *b, size_t rsb, size_t csb, C *c, size_t ldc);
+
+    /**
+     * @brief Matrix vector product of any supported type, rows of A being shared between threads.
+     */
+    template<typename T>
+    static void gemvRows(size_t n, size_t p, const T *a, size_t lda, const T *x, T *y);
+
+    /**
+     * @brief Linear combination of count arrays, the pointer to the k-th one being `rows(k)`, by blocks of components.
+     */
+    template<typename T, typename R>
+    static void combineBlocks(size_t n, size_t count, const R &rows, const T *s, T *y);
+
+    /**
+     * @brief Pack A by panels of NBLAS_MR rows, KR consecutive columns of a row being stored together.
+     */
+    template<typename TA, typename P, size_t KR>
+    static void packA(size_t mc, size_t kc, const TA *a, size_t rs, size_t cs, P *pa);
+
+    /**
+     * @brief Pack B by panels of NR columns, KR consecutive rows of a column being stored together.
+     */
+    template<typename TB, typename P, size_t NR, size_t KR>
+    static void packB(size_t kc, size_t nc, const TB *b, size_t rs, size_t cs, P *pb);
+
+    /**
+     * @brief Product of a packed mc x kc block of A with a packed kc x nc block of B added to C.
+     */
+    template<typename P, typename C, size_t NR>
+    static void macroKernel(size_t mc, size_t nc, size_t kc, const P *pa, const P *pb, C *c, size_t ldc);
+
+    /**
+     * @brief Product of a NBLAS_MR panel of A with a NBLAS_NR panel of B added to the full C block.
+     */
+    static void microKernel(size_t kc, const double_t *pa, const double_t *pb, double_t *c, size_t ldc);
+
+    static void microKernel(size_t kc, const float *pa, const float *pb, float *c, size_t ldc);
+
+    static void microKernel(size_t kc, const int16_t *pa, const int16_t *pb, int32_t *c, size_t ldc);
+
+    /**
+     * @brief Sum of the components of x, or dot product of x and y when y is not null, block by block.
+     */
+    template<typename T>
+    static T sumBlocks(size_t n, const T *x, const T *y);
+
+    /**
+     * @brief Indices of the extremums of x or of its absolute values, block by block.
+     */
+    template<typename T, bool ABS>
+    static void minmaxBlocks(size_t n, const T *x, size_t &imin, size_t &imax);
+};
+
+/** @} */
+
+#endif //MATHTOOLKIT_NBLAS_H
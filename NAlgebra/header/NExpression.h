@@ -0,0 +1,393 @@
+//
+// Created by bendou on 31/01/19.
+//
+
+#ifndef MATHTOOLKIT_NEXPRESSION_H
+#define MATHTOOLKIT_NEXPRESSION_H
+
+#include <type_traits>
+#include <utility>
+#include "thirdparty.h"
+
+template<typename T>
+class NVector;
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   NExpr
+ * @date    31/01/2019
+ * @author  samiBendou
+ * @brief   Element-wise expression on vectors evaluated lazily.
+ *
+ * @details The algebraical operators of `NVector` return expressions instead of vectors. An expression is a tree
+ *          whose leaves refer to the operands and whose nodes hold the operations. It is computed in a single loop
+ *          when assigned to a vector, so that `u + s * v - w` doesn't create any temporary vector.
+ *
+ *          Leaves take the range given by the browse indices of the operand when the expression is built, so
+ *          `u(0, 1) + v(1, 2)` works the same way as with vectors.
+ *
+ *          The read-only methods of `NVector`, such as `(u + v).max()` or `(u + v)(0, 1)`, compute the expression in
+ *          a temporary vector first. `eval()` gives this vector, to call the other methods of `NVector` on it.
+ *
+ *          Expressions refer to the vectors they are built from, except temporary vectors which are moved into the
+ *          expression. An expression stored with `auto` must not outlive the vectors it refers to.
+ *
+ *          `E` is the type of the expression and `T` the type of the components.
+ */
+template<typename E, typename T>
+class NExpr {
+
+public:
+
+    typedef T scalar_type;
+
+    inline const E &self() const { return static_cast<const E &>(*this); }
+
+    inline size_t dim() const { return self().dim(); }
+
+    inline T operator[](size_t k) const { return self()[k]; }
+
+    /**
+     * @return true if computing the expression in the n components at dst reads components already overwritten.
+     */
+    inline bool aliases(const T *dst, size_t n) const { return self().aliases(dst, n); }
+
+    /**
+     * @return vector computed by the expression.
+     */
+    inline NVector<T> eval() const { return NVector<T>(*this); }
+
+    // Read-only methods of NVector, computed on the vector of the expression
+
+    inline std::string str() const { return eval().str(); }
+
+    inline std::vector<T> array() const { return eval().array(); }
+
+    inline std::pair<T, T> minmax() const { return eval().minmax(); }
+
+    inline std::pair<size_t, size_t> minmaxIndex() const { return eval().minmaxIndex(); }
+
+    inline T max() const { return eval().max(); }
+
+    inline T min() const { return eval().min(); }
+
+    inline size_t maxIndex() const { return eval().maxIndex(); }
+
+    inline size_t minIndex() const { return eval().minIndex(); }
+
+    inline T maxAbs() const { return eval().maxAbs(); }
+
+    inline T minAbs() const { return eval().minAbs(); }
+
+    inline size_t maxAbsIndex() const { return eval().maxAbsIndex(); }
+
+    inline size_t minAbsIndex() const { return eval().minAbsIndex(); }
+
+    inline std::pair<size_t, size_t> minmaxAbsIndex() const { return eval().minmaxAbsIndex(); }
+
+    inline T sum() const { return eval().sum(); }
+
+    inline T operator()(long k) const { return eval()(k); }
+
+    inline NVector<T> operator()(size_t k1, size_t k2) const {
+        const NVector<T> u = eval();
+        return u(k1, k2);
+    }
+
+    /**
+     * @return norm of the expression, computed without evaluating it.
+     */
+    T norm() const {
+        using std::sqrt;
+        T dot = 0, x;
+
+        for (size_t k = 0; k < dim(); ++k) {
+            x = (*this)[k];
+            dot += x * x;
+        }
+        return sqrt(dot);
+    }
+};
+
+/**
+ * @brief Leaf of an expression, range of components of a vector.
+ */
+template<typename T>
+class NLeaf : public NExpr<NLeaf<T>, T> {
+
+public:
+
+    explicit NLeaf(const NVector<T> &u);
+
+    inline size_t dim() const { return _dim; }
+
+    inline T operator[](size_t k) const { return _data[k]; }
+
+    // Writing the component k after reading it is safe, so only shifted ranges alias
+    inline bool aliases(const T *dst, size_t n) const { return _data != dst && _data < dst + n && dst < _data + _dim; }
+
+protected:
+
+    const T *_data;
+
+    size_t _dim;
+};
+
+/**
+ * @brief Leaf of an expression taking the components of a temporary vector.
+ */
+template<typename T>
+class NTemp : public NExpr<NTemp<T>, T> {
+
+public:
+
+    // Only the browsed components are taken
+    explicit NTemp(NVector<T> &&u) : _u(std::move(u)) {}
+
+    inline size_t dim() const { return _u.size(); }
+
+    inline T operator[](size_t k) const { return _u.data()[k]; }
+
+    inline bool aliases(const T *, size_t) const { return false; }
+
+protected:
+
+    NVector<T> _u;
+};
+
+/**
+ * @brief Node combining two expressions component by component.
+ */
+template<typename L, typename R, typename Op>
+class NBinary : public NExpr<NBinary<L, R, Op>, typename L::scalar_type> {
+
+public:
+
+    typedef typename L::scalar_type T;
+
+    NBinary(L l, R r) : _l(std::move(l)), _r(std::move(r)) { assert(_l.dim() == _r.dim()); }
+
+    inline size_t dim() const { return _l.dim(); }
+
+    inline T operator[](size_t k) const { return Op::apply(_l[k], _r[k]); }
+
+    inline bool aliases(const T *dst, size_t n) const { return _l.aliases(dst, n) || _r.aliases(dst, n); }
+
+protected:
+
+    L _l;
+
+    R _r;
+};
+
+/**
+ * @brief Node combining the components of an expression with a scalar.
+ */
+template<typename E, typename Op>
+class NScalar : public NExpr<NScalar<E, Op>, typename E::scalar_type> {
+
+public:
+
+    typedef typename E::scalar_type T;
+
+    NScalar(E e, T s) : _e(std::move(e)), _s(s) {}
+
+    inline size_t dim() const { return _e.dim(); }
+
+    inline T operator[](size_t k) const { return Op::apply(_e[k], _s); }
+
+    inline bool aliases(const T *dst, size_t n) const { return _e.aliases(dst, n); }
+
+protected:
+
+    E _e;
+
+    T _s;
+};
+
+// Operations, computed the same way as the compound operators of the components
+
+struct NAdd {
+    template<typename T>
+    static inline T apply(T x, const T &y) { return x += y; }
+};
+
+struct NSub {
+    template<typename T>
+    static inline T apply(T x, const T &y) { return x -= y; }
+};
+
+struct NProd {
+    template<typename T>
+    static inline T apply(T x, const T &y) { return x *= y; }
+};
+
+struct NDiv {
+    template<typename T>
+    static inline T apply(T x, const T &y) { return x /= y; }
+};
+
+/**
+ * @brief Operand of an expression, either a `NVector<T>` or an expression.
+ * @details `X` is the type deduced for a forwarding reference. Vectors are referred by the expression, unless they are
+ *          temporaries which are moved into it. Derived classes of `NVector` such as `NPMatrix` keep their own
+ *          operators and aren't operands.
+ */
+template<typename X, typename = void>
+struct NOperand {
+};
+
+template<typename T>
+struct NOperand<const NVector<T> &> {
+    typedef NLeaf<T> type;
+    typedef T scalar_type;
+    static const bool expr = false;
+
+    static inline type get(const NVector<T> &u) { return type(u); }
+};
+
+template<typename T>
+struct NOperand<NVector<T> &> : NOperand<const NVector<T> &> {
+};
+
+template<typename T>
+struct NOperand<NVector<T> > {
+    typedef NTemp<T> type;
+    typedef T scalar_type;
+    static const bool expr = false;
+
+    static inline type get(NVector<T> &&u) { return type(std::move(u)); }
+};
+
+template<typename X>
+struct NOperand<X, typename std::enable_if<std::is_base_of<NExpr<typename std::decay<X>::type,
+        typename std::decay<X>::type::scalar_type>, typename std::decay<X>::type>::value>::type> {
+    typedef typename std::decay<X>::type type;
+    typedef typename type::scalar_type scalar_type;
+    static const bool expr = true;
+
+    static inline type get(X &&e) { return std::forward<X>(e); }
+};
+
+template<typename L, typename R, typename Op, typename = void>
+struct NBinaryOf {
+};
+
+template<typename L, typename R, typename Op>
+struct NBinaryOf<L, R, Op, typename std::enable_if<std::is_same<typename NOperand<L>::scalar_type,
+        typename NOperand<R>::scalar_type>::value>::type> {
+    typedef NBinary<typename NOperand<L>::type, typename NOperand<R>::type, Op> type;
+};
+
+// At least one operand is an expression, operations on two vectors are defined by NVector
+template<typename L, typename R, typename = void>
+struct NExprOf {
+};
+
+template<typename L, typename R>
+struct NExprOf<L, R, typename std::enable_if<(NOperand<L>::expr || NOperand<R>::expr) &&
+                                             std::is_same<typename NOperand<L>::scalar_type,
+                                                     typename NOperand<R>::scalar_type>::value>::type> {
+    typedef typename NOperand<L>::scalar_type type;
+};
+
+/**
+ * @brief Add two vectors.
+ * @details Using usual addition \f$ (u_0 + v_0, u_1 + v_1, ...) \f$.
+ * @return expression of \f$ u + v \f$
+ */
+template<typename L, typename R>
+inline typename NBinaryOf<L, R, NAdd>::type operator+(L &&u, R &&v) {
+    return typename NBinaryOf<L, R, NAdd>::type(NOperand<L>::get(std::forward<L>(u)),
+                                                NOperand<R>::get(std::forward<R>(v)));
+}
+
+/**
+ * @brief Substract two vectors.
+ * @details Using usual difference \f$ (u_0 - v_0, u_1 - v_1, ...) \f$.
+ * @return expression of \f$ u - v \f$
+ */
+template<typename L, typename R>
+inline typename NBinaryOf<L, R, NSub>::type operator-(L &&u, R &&v) {
+    return typename NBinaryOf<L, R, NSub>::type(NOperand<L>::get(std::forward<L>(u)),
+                                                NOperand<R>::get(std::forward<R>(v)));
+}
+
+/**
+ * @brief Opposite of vector.
+ * @return expression of \f$ (-u_0, -u_1, ...). \f$
+ */
+template<typename E>
+inline NScalar<typename NOperand<E>::type, NProd> operator-(E &&u) {
+    return NScalar<typename NOperand<E>::type, NProd>(NOperand<E>::get(std::forward<E>(u)), -1);
+}
+
+/**
+ * @brief Multiply vector by scalar.
+ * @details Using usual scalar multiplication \f$ (s \cdot u_0, s \cdot u_1, ...) \f$.
+ * @return expression of \f$ s \cdot u \f$
+ */
+template<typename E>
+inline NScalar<typename NOperand<E>::type, NProd> operator*(typename NOperand<E>::scalar_type s, E &&u) {
+    return NScalar<typename NOperand<E>::type, NProd>(NOperand<E>::get(std::forward<E>(u)), s);
+}
+
+template<typename E>
+inline NScalar<typename NOperand<E>::type, NProd> operator*(E &&u, typename NOperand<E>::scalar_type s) {
+    return s * std::forward<E>(u);
+}
+
+/**
+ * @brief Divide vector by scalar.
+ * @return expression of \f$ s^{-1} \cdot u \f$
+ */
+template<typename E>
+inline NScalar<typename NOperand<E>::type, NDiv> operator/(E &&u, typename NOperand<E>::scalar_type s) {
+    return NScalar<typename NOperand<E>::type, NDiv>(NOperand<E>::get(std::forward<E>(u)), s);
+}
+
+/**
+ * @brief Dot product of expressions, computed without evaluating them.
+ * @return value of \f$ u \cdot v \f$
+ */
+template<typename L, typename R>
+inline typename NExprOf<L, R>::type operator|(L &&u, R &&v) {
+    typename NExprOf<L, R>::type dot = 0;
+    const auto &a = NOperand<L>::get(std::forward<L>(u));
+    const auto &b = NOperand<R>::get(std::forward<R>(v));
+
+    assert(a.dim() == b.dim());
+    for (size_t k = 0; k < a.dim(); ++k) {
+        dot += b[k] * a[k];
+    }
+    return dot;
+}
+
+/**
+ * @brief Norm of an expression.
+ * @return value of \f$ ||u|| \f$.
+ */
+template<typename E>
+inline typename std::enable_if<NOperand<E>::expr, typename NOperand<E>::scalar_type>::type operator!(const E &u) {
+    return u.norm();
+}
+
+/**
+ * @brief Distance between expressions.
+ * @return value of \f$ ||u - v|| \f$.
+ */
+template<typename L, typename R>
+inline typename NExprOf<L, R>::type operator/(const L &u, const R &v) { return !(u - v); }
+
+/**
+ * @brief Stream insertion of the vector computed by an expression.
+ */
+template<typename E>
+inline typename std::enable_if<NOperand<E>::expr, std::ostream &>::type operator<<(std::ostream &os, const E &u) {
+    return os << NVector<typename NOperand<E>::scalar_type>(u);
+}
+
+/** @} */
+
+#endif //MATHTOOLKIT_NEXPRESSION_H
@@ -0,0 +1,466 @@
+//
+// Created by bendou on 02/02/19.
+//
+
+#ifndef MATHTOOLKIT_NFIXED_H
+#define MATHTOOLKIT_NFIXED_H
+
+#include <algorithm>
+#include <NVector.h>
+
+// Pack of the indices 0, ..., N - 1, element-wise operations are written as single constexpr expressions over it
+
+template<size_t... I>
+struct NIndices {
+};
+
+template<size_t N, size_t... I>
+struct NMakeIndices : NMakeIndices<N - 1, N - 1, I...> {
+};
+
+template<size_t... I>
+struct NMakeIndices<0, I...> {
+    typedef NIndices<I...> type;
+};
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   NFixedVector
+ * @date    02/02/2019
+ * @author  samiBendou
+ * @brief   Vector of `N` components stored in place.
+ *
+ * @details Unlike `NVector`, the components are stored in an array member. Fixed size vectors are created on the stack
+ *          without allocation and copied as plain values. They have no browse indices and no virtual methods, all the
+ *          operations are inline and most of them are `constexpr` :
+ *
+ *          @code{.cpp}
+ *          constexpr NFixedVector<double_t, 3> u(1, 2, 3), v = 2.0 * u;
+ *          static_assert((u | v) == 28, "computed at compile time");
+ *          @endcode
+ *
+ *          Operators have the same meaning as the ones of `NVector`. Vectors are converted from a `NVector<T>` with the
+ *          explicit constructor and to a `NVector<T>` with `array()`.
+ */
+template<typename T, size_t N>
+class NFixedVector {
+
+    typedef typename NMakeIndices<N>::type Indices;
+
+public:
+
+    /**
+     * @brief Construct a vector with all the components set to `0`.
+     */
+    constexpr NFixedVector() : _data{} {}
+
+    /**
+     * @brief Construct a vector from its `N` components, eg. `NFixedVector<double_t, 3> u(1, 2, 3)`.
+     */
+    template<typename... Args, typename = typename std::enable_if<sizeof...(Args) == N>::type>
+    constexpr NFixedVector(Args... args) : _data{static_cast<T>(args)...} {}
+
+    /**
+     * @brief Construct a vector by copying the components of `u`, which must have `N` components.
+     * @details Only the first `N` components are copied when assertions are disabled, the others being left to `0`.
+     */
+    explicit NFixedVector(const NVector<T> &u) : _data{} {
+        // The first browsed component is read before dim() resets the browse indices of u
+        auto first = u.begin();
+        size_t dim = u.empty() ? 0 : u.dim();
+
+        assert(dim == N);
+        std::copy_n(first, std::min(N, dim), _data);
+    }
+
+    // GETTERS
+
+    constexpr size_t dim() const { return N; }
+
+    inline const T *data() const { return _data; }
+
+    inline T *data() { return _data; }
+
+    inline std::vector<T> array() const { return std::vector<T>(_data, _data + N); }
+
+    /**
+     * @return string representation, the same as the one of `NVector`.
+     */
+    std::string str() const {
+        using std::abs;
+        std::stringstream stream;
+
+        stream << '(';
+        for (size_t k = 0; k < N; ++k) {
+            stream << (_data[k] >= 0 ? ' ' : '-') << abs(_data[k]);
+        }
+        stream << " )";
+        return stream.str();
+    }
+
+    inline friend std::ostream &operator<<(std::ostream &os, const NFixedVector &u) { return os << u.str(); }
+
+    // ITERATORS
+
+    inline T *begin() { return _data; }
+
+    inline const T *begin() const { return _data; }
+
+    inline T *end() { return _data + N; }
+
+    inline const T *end() const { return _data + N; }
+
+    // ACCESS
+
+    // Temporaries are read with the const overload, so that components of constexpr expressions are constexpr
+    constexpr T operator[](size_t k) const & { return _data[k]; }
+
+    inline T &operator[](size_t k) & { return _data[k]; }
+
+    // ALGEBRAICAL OPERATORS
+
+    inline friend constexpr NFixedVector operator+(const NFixedVector &u, const NFixedVector &v) {
+        return add(u, v, Indices());
+    }
+
+    inline friend constexpr NFixedVector operator-(const NFixedVector &u, const NFixedVector &v) {
+        return sub(u, v, Indices());
+    }
+
+    inline friend constexpr NFixedVector operator-(const NFixedVector &u) { return prod(u, -1, Indices()); }
+
+    inline friend constexpr NFixedVector operator*(T s, const NFixedVector &u) { return prod(u, s, Indices()); }
+
+    inline friend constexpr NFixedVector operator*(const NFixedVector &u, T s) { return prod(u, s, Indices()); }
+
+    inline friend constexpr NFixedVector operator/(const NFixedVector &u, T s) { return div(u, s, Indices()); }
+
+    /**
+     * @brief Dot product, summed in the order of the components as `NVector` does.
+     */
+    inline friend constexpr T operator|(const NFixedVector &u, const NFixedVector &v) { return dot(u, v, 0, 0); }
+
+    inline friend T operator!(const NFixedVector &u) {
+        using std::sqrt;
+        return sqrt(u | u);
+    }
+
+    inline friend T operator/(const NFixedVector &u, const NFixedVector &v) { return !(u - v); }
+
+    // COMPOUND OPERATORS
+
+    inline NFixedVector &operator+=(const NFixedVector &u) {
+        for (size_t k = 0; k < N; ++k) {
+            _data[k] += u._data[k];
+        }
+        return *this;
+    }
+
+    inline NFixedVector &operator-=(const NFixedVector &u) {
+        for (size_t k = 0; k < N; ++k) {
+            _data[k] -= u._data[k];
+        }
+        return *this;
+    }
+
+    inline NFixedVector &operator*=(T s) {
+        for (size_t k = 0; k < N; ++k) {
+            _data[k] *= s;
+        }
+        return *this;
+    }
+
+    inline NFixedVector &operator/=(T s) {
+        for (size_t k = 0; k < N; ++k) {
+            _data[k] /= s;
+        }
+        return *this;
+    }
+
+    // COMPARISON OPERATORS
+
+    /**
+     * @brief Equality of two vectors.
+     * @return true if \f$ ||u - v|| \leq \epsilon \f$, as `NVector`.
+     */
+    inline friend bool operator==(const NFixedVector &u, const NFixedVector &v) { return u / v <= EPSILON; }
+
+    inline friend bool operator==(const NFixedVector &u, T s) { return s < EPSILON && !u <= EPSILON; }
+
+    inline friend bool operator==(T s, const NFixedVector &u) { return u == s; }
+
+    inline friend bool operator!=(const NFixedVector &u, const NFixedVector &v) { return !(u == v); }
+
+    inline friend bool operator!=(const NFixedVector &u, T s) { return !(u == s); }
+
+    inline friend bool operator!=(T s, const NFixedVector &u) { return !(u == s); }
+
+    // STATIC FUNCTIONS
+
+    static constexpr NFixedVector zeros() { return NFixedVector(); }
+
+    static constexpr NFixedVector ones() { return scalar(1); }
+
+    static constexpr NFixedVector scalar(T s) { return scalar(s, Indices()); }
+
+    /**
+     * @return \f$ k^{th} \f$ vector of the canonical basis.
+     */
+    static constexpr NFixedVector cano(size_t k) { return cano(k, Indices()); }
+
+protected:
+
+    template<size_t... I>
+    static constexpr NFixedVector add(const NFixedVector &u, const NFixedVector &v, NIndices<I...>) {
+        return NFixedVector(u._data[I] + v._data[I]...);
+    }
+
+    template<size_t... I>
+    static constexpr NFixedVector sub(const NFixedVector &u, const NFixedVector &v, NIndices<I...>) {
+        return NFixedVector(u._data[I] - v._data[I]...);
+    }
+
+    template<size_t... I>
+    static constexpr NFixedVector prod(const NFixedVector &u, T s, NIndices<I...>) {
+        return NFixedVector(u._data[I] * s...);
+    }
+
+    template<size_t... I>
+    static constexpr NFixedVector div(const NFixedVector &u, T s, NIndices<I...>) {
+        return NFixedVector(u._data[I] / s...);
+    }
+
+    static constexpr T dot(const NFixedVector &u, const NFixedVector &v, size_t k, T acc) {
+        return k < N ? dot(u, v, k + 1, acc + u._data[k] * v._data[k]) : acc;
+    }
+
+    template<size_t... I>
+    static constexpr NFixedVector scalar(T s, NIndices<I...>) { return NFixedVector(((void) I, s)...); }
+
+    template<size_t... I>
+    static constexpr NFixedVector cano(size_t k, NIndices<I...>) { return NFixedVector((I == k ? 1 : 0)...); }
+
+    T _data[N];
+};
+
+/**
+ * @class   NFixedMatrix
+ * @date    02/02/2019
+ * @author  samiBendou
+ * @brief   \f$ N \times M \f$ matrix stored in place.
+ *
+ * @details The components are stored row by row in an array member, as for `NFixedVector` there is no allocation and
+ *          most of the operations are `constexpr`. The product of matrices and vectors of fixed size is computed
+ *          with `*`, the sizes being checked at compile time.
+ */
+template<typename T, size_t N, size_t M = N>
+class NFixedMatrix {
+
+    typedef typename NMakeIndices<N * M>::type Indices;
+
+public:
+
+    /**
+     * @brief Construct a matrix with all the components set to `0`.
+     */
+    constexpr NFixedMatrix() : _data{} {}
+
+    /**
+     * @brief Construct a matrix from its components given row by row.
+     */
+    template<typename... Args, typename = typename std::enable_if<sizeof...(Args) == N * M>::type>
+    constexpr NFixedMatrix(Args... args) : _data{static_cast<T>(args)...} {}
+
+    // GETTERS
+
+    constexpr size_t n() const { return N; }
+
+    constexpr size_t p() const { return M; }
+
+    inline const T *data() const { return _data; }
+
+    inline T *data() { return _data; }
+
+    constexpr NFixedVector<T, M> row(size_t i) const { return row(i, typename NMakeIndices<M>::type()); }
+
+    constexpr NFixedVector<T, N> col(size_t j) const { return col(j, typename NMakeIndices<N>::type()); }
+
+    constexpr NFixedMatrix<T, M, N> transposed() const { return transposed(typename NMakeIndices<M * N>::type()); }
+
+    std::string str() const {
+        std::stringstream stream;
+
+        for (size_t i = 0; i < N; ++i) {
+            stream << "\n" << row(i);
+        }
+        return stream.str();
+    }
+
+    inline friend std::ostream &operator<<(std::ostream &os, const NFixedMatrix &m) { return os << m.str(); }
+
+    // ACCESS
+
+    constexpr T operator()(size_t i, size_t j) const & { return _data[i * M + j]; }
+
+    inline T &operator()(size_t i, size_t j) & { return _data[i * M + j]; }
+
+    // ALGEBRAICAL OPERATORS
+
+    inline friend constexpr NFixedMatrix operator+(const NFixedMatrix &a, const NFixedMatrix &b) {
+        return add(a, b, Indices());
+    }
+
+    inline friend constexpr NFixedMatrix operator-(const NFixedMatrix &a, const NFixedMatrix &b) {
+        return sub(a, b, Indices());
+    }
+
+    inline friend constexpr NFixedMatrix operator-(const NFixedMatrix &a) { return prod(a, -1, Indices()); }
+
+    inline friend constexpr NFixedMatrix operator*(T s, const NFixedMatrix &a) { return prod(a, s, Indices()); }
+
+    inline friend constexpr NFixedMatrix operator*(const NFixedMatrix &a, T s) { return prod(a, s, Indices()); }
+
+    inline friend constexpr NFixedMatrix operator/(const NFixedMatrix &a, T s) { return div(a, s, Indices()); }
+
+    /**
+     * @brief Linear map \f$ A u \f$.
+     */
+    inline friend constexpr NFixedVector<T, N> operator*(const NFixedMatrix &a, const NFixedVector<T, M> &u) {
+        return map(a, u, typename NMakeIndices<N>::type());
+    }
+
+    /**
+     * @brief Matrix product \f$ A B \f$ of a \f$ N \times M \f$ and a \f$ M \times L \f$ matrix.
+     */
+    template<size_t L>
+    inline friend constexpr NFixedMatrix<T, N, L> operator*(const NFixedMatrix &a, const NFixedMatrix<T, M, L> &b) {
+        return product(a, b, typename NMakeIndices<N * L>::type());
+    }
+
+    // COMPOUND OPERATORS
+
+    inline NFixedMatrix &operator+=(const NFixedMatrix &m) {
+        for (size_t k = 0; k < N * M; ++k) {
+            _data[k] += m._data[k];
+        }
+        return *this;
+    }
+
+    inline NFixedMatrix &operator-=(const NFixedMatrix &m) {
+        for (size_t k = 0; k < N * M; ++k) {
+            _data[k] -= m._data[k];
+        }
+        return *this;
+    }
+
+    inline NFixedMatrix &operator*=(T s) {
+        for (size_t k = 0; k < N * M; ++k) {
+            _data[k] *= s;
+        }
+        return *this;
+    }
+
+    inline NFixedMatrix &operator/=(T s) {
+        for (size_t k = 0; k < N * M; ++k) {
+            _data[k] /= s;
+        }
+        return *this;
+    }
+
+    // COMPARISON OPERATORS
+
+    inline friend bool operator==(const NFixedMatrix &a, const NFixedMatrix &b) {
+        using std::sqrt;
+        T dot = 0;
+
+        for (size_t k = 0; k < N * M; ++k) {
+            dot += (a._data[k] - b._data[k]) * (a._data[k] - b._data[k]);
+        }
+        return sqrt(dot) <= EPSILON;
+    }
+
+    inline friend bool operator!=(const NFixedMatrix &a, const NFixedMatrix &b) { return !(a == b); }
+
+    // STATIC FUNCTIONS
+
+    static constexpr NFixedMatrix zeros() { return NFixedMatrix(); }
+
+    static constexpr NFixedMatrix ones() { return scalar(1, Indices()); }
+
+    /**
+     * @return \f$ N \times M \f$ matrix with ones on its diagonal.
+     */
+    static constexpr NFixedMatrix eye() { return eye(Indices()); }
+
+protected:
+
+    template<size_t... I>
+    static constexpr NFixedMatrix add(const NFixedMatrix &a, const NFixedMatrix &b, NIndices<I...>) {
+        return NFixedMatrix(a._data[I] + b._data[I]...);
+    }
+
+    template<size_t... I>
+    static constexpr NFixedMatrix sub(const NFixedMatrix &a, const NFixedMatrix &b, NIndices<I...>) {
+        return NFixedMatrix(a._data[I] - b._data[I]...);
+    }
+
+    template<size_t... I>
+    static constexpr NFixedMatrix prod(const NFixedMatrix &a, T s, NIndices<I...>) {
+        return NFixedMatrix(a._data[I] * s...);
+    }
+
+    template<size_t... I>
+    static constexpr NFixedMatrix div(const NFixedMatrix &a, T s, NIndices<I...>) {
+        return NFixedMatrix(a._data[I] / s...);
+    }
+
+    template<size_t... I>
+    static constexpr NFixedMatrix scalar(T s, NIndices<I...>) { return NFixedMatrix(((void) I, s)...); }
+
+    template<size_t... I>
+    static constexpr NFixedMatrix eye(NIndices<I...>) { return NFixedMatrix((I / M == I % M ? 1 : 0)...); }
+
+    template<size_t... I>
+    constexpr NFixedVector<T, M> row(size_t i, NIndices<I...>) const {
+        return NFixedVector<T, M>(_data[i * M + I]...);
+    }
+
+    template<size_t... I>
+    constexpr NFixedVector<T, N> col(size_t j, NIndices<I...>) const {
+        return NFixedVector<T, N>(_data[I * M + j]...);
+    }
+
+    template<size_t... I>
+    constexpr NFixedMatrix<T, M, N> transposed(NIndices<I...>) const {
+        return NFixedMatrix<T, M, N>(_data[(I % N) * M + I / N]...);
+    }
+
+    // Dot products of the row i of a with u and with the column j of b, summed in the order of the components
+    static constexpr T dot(const NFixedMatrix &a, const NFixedVector<T, M> &u, size_t i, size_t k, T acc) {
+        return k < M ? dot(a, u, i, k + 1, acc + a._data[i * M + k] * u[k]) : acc;
+    }
+
+    template<size_t L>
+    static constexpr T dot(const NFixedMatrix &a, const NFixedMatrix<T, M, L> &b, size_t i, size_t j, size_t k,
+                           T acc) {
+        return k < M ? dot(a, b, i, j, k + 1, acc + a._data[i * M + k] * b(k, j)) : acc;
+    }
+
+    template<size_t... I>
+    static constexpr NFixedVector<T, N> map(const NFixedMatrix &a, const NFixedVector<T, M> &u, NIndices<I...>) {
+        return NFixedVector<T, N>(dot(a, u, I, 0, 0)...);
+    }
+
+    template<size_t L, size_t... I>
+    static constexpr NFixedMatrix<T, N, L> product(const NFixedMatrix &a, const NFixedMatrix<T, M, L> &b,
+                                                   NIndices<I...>) {
+        return NFixedMatrix<T, N, L>(dot(a, b, I / L, I % L, 0, 0)...);
+    }
+
+    T _data[N * M];
+};
+
+/** @} */
+
+#endif //MATHTOOLKIT_NFIXED_H
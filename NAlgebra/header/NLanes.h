@@ -0,0 +1,172 @@
+//
+// Created by bendou on 03/02/19.
+//
+
+#ifndef MATHTOOLKIT_NLANES_H
+#define MATHTOOLKIT_NLANES_H
+
+#include "thirdparty.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+// Lanes of registers used by the kernels written once for a whole register and for a single scalar. The kernels are
+// templates on the lane type, they process `NLanes::size` elements at a time and the remaining ones with `NLane`.
+// `NLanesF` and `NLaneF` are their single precision counterparts.
+
+struct NLane {
+    typedef double_t scalar;
+    typedef double_t type;
+    typedef bool mask;
+    static const size_t size = 1;
+
+    static inline type load(const double_t *p) { return *p; }
+
+    static inline void store(double_t *p, type x) { *p = x; }
+
+    static inline type set(double_t x) { return x; }
+
+    static inline type abs(type x) { return std::abs(x); }
+
+    static inline type sqrt(type x) { return std::sqrt(x); }
+
+    static inline mask greater(type x, type y) { return x > y; }
+
+    static inline mask equal(type x, type y) { return x == y; }
+
+    static inline bool any(mask m) { return m; }
+
+    static inline type blend(type x, type y, mask m) { return m ? y : x; }
+
+    static inline type add(type x, type y) { return x + y; }
+
+    static inline type sub(type x, type y) { return x - y; }
+
+    static inline type mul(type x, type y) { return x * y; }
+
+    static inline type div(type x, type y) { return x / y; }
+
+    // a b + c
+    static inline type fmadd(type a, type b, type c) { return a * b + c; }
+
+    // c - a b
+    static inline type fnmadd(type a, type b, type c) { return c - a * b; }
+};
+
+struct NLaneF {
+    typedef float scalar;
+    typedef float type;
+    typedef bool mask;
+    static const size_t size = 1;
+
+    static inline type load(const float *p) { return *p; }
+
+    static inline void store(float *p, type x) { *p = x; }
+
+    static inline type set(float x) { return x; }
+
+    static inline type abs(type x) { return std::abs(x); }
+
+    static inline type sqrt(type x) { return std::sqrt(x); }
+
+    static inline mask greater(type x, type y) { return x > y; }
+
+    static inline mask equal(type x, type y) { return x == y; }
+
+    static inline bool any(mask m) { return m; }
+
+    static inline type blend(type x, type y, mask m) { return m ? y : x; }
+
+    static inline type add(type x, type y) { return x + y; }
+
+    static inline type sub(type x, type y) { return x - y; }
+
+    static inline type mul(type x, type y) { return x * y; }
+
+    static inline type div(type x, type y) { return x / y; }
+
+    static inline type fmadd(type a, type b, type c) { return a * b + c; }
+
+    static inline type fnmadd(type a, type b, type c) { return c - a * b; }
+};
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+struct NLanes {
+    typedef double_t scalar;
+    typedef __m256d type;
+    typedef __m256d mask;
+    static const size_t size = 4;
+
+    static inline type load(const double_t *p) { return _mm256_loadu_pd(p); }
+
+    static inline void store(double_t *p, type x) { _mm256_storeu_pd(p, x); }
+
+    static inline type set(double_t x) { return _mm256_set1_pd(x); }
+
+    static inline type abs(type x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+
+    static inline type sqrt(type x) { return _mm256_sqrt_pd(x); }
+
+    static inline mask greater(type x, type y) { return _mm256_cmp_pd(x, y, _CMP_GT_OQ); }
+
+    static inline mask equal(type x, type y) { return _mm256_cmp_pd(x, y, _CMP_EQ_OQ); }
+
+    static inline bool any(mask m) { return _mm256_movemask_pd(m) != 0; }
+
+    static inline type blend(type x, type y, mask m) { return _mm256_blendv_pd(x, y, m); }
+
+    static inline type add(type x, type y) { return _mm256_add_pd(x, y); }
+
+    static inline type sub(type x, type y) { return _mm256_sub_pd(x, y); }
+
+    static inline type mul(type x, type y) { return _mm256_mul_pd(x, y); }
+
+    static inline type div(type x, type y) { return _mm256_div_pd(x, y); }
+
+    static inline type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+
+    static inline type fnmadd(type a, type b, type c) { return _mm256_fnmadd_pd(a, b, c); }
+};
+
+struct NLanesF {
+    typedef float scalar;
+    typedef __m256 type;
+    typedef __m256 mask;
+    static const size_t size = 8;
+
+    static inline type load(const float *p) { return _mm256_loadu_ps(p); }
+
+    static inline void store(float *p, type x) { _mm256_storeu_ps(p, x); }
+
+    static inline type set(float x) { return _mm256_set1_ps(x); }
+
+    static inline type abs(type x) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x); }
+
+    static inline type sqrt(type x) { return _mm256_sqrt_ps(x); }
+
+    static inline mask greater(type x, type y) { return _mm256_cmp_ps(x, y, _CMP_GT_OQ); }
+
+    static inline mask equal(type x, type y) { return _mm256_cmp_ps(x, y, _CMP_EQ_OQ); }
+
+    static inline bool any(mask m) { return _mm256_movemask_ps(m) != 0; }
+
+    static inline type blend(type x, type y, mask m) { return _mm256_blendv_ps(x, y, m); }
+
+    static inline type add(type x, type y) { return _mm256_add_ps(x, y); }
+
+    static inline type sub(type x, type y) { return _mm256_sub_ps(x, y); }
+
+    static inline type mul(type x, type y) { return _mm256_mul_ps(x, y); }
+
+    static inline type div(type x, type y) { return _mm256_div_ps(x, y); }
+
+    static inline type fmadd(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+
+    static inline type fnmadd(type a, type b, type c) { return _mm256_fnmadd_ps(a, b, c); }
+};
+
+#endif
+
+#endif //MATHTOOLKIT_NLANES_H
@@ -4,6 +4,15 @@
 #include "thirdparty.h"
 #include <NVector.h>
 
+// Number of columns of the panels of the blocked LUP decomposition
+#define NPMATRIX_LUP_NB 256
+
+// Number of columns or rows below which panels and triangular systems are solved without matrix products
+#define NPMATRIX_LUP_MIN 16
+
+// Number of Householder reflectors of the QR decomposition applied at once to the rest of the matrix
+#define NPMATRIX_QR_NB 32
+
 /**
  * @ingroup NAlgebra
  * @{
@@ -14,7 +23,7 @@
  * @brief   Representation of dense matrices of arbitrary size in a template field `T`.
  *
  * @details The matrix components are stored in a linear form using the index transformation \f$ k = p i + j \f$.
- *          The underlying `std::vector<T>` is represented as `t[p * i + j]`.
+ *          The underlying `NStorage<T>` is represented as `t[p * i + j]`.
  *          The underlying `NVector<T>` is \f$ (A_{00}, A_{01}, ..., A_{0(P - 1)}, A_{10}, ..., A_{1(P - 1)}, ..., A_{(N-1)0}, ...) \f$.
  *
  *          @section Features
@@ -26,6 +35,21 @@
  *
  *          The \f$ LU \f$ decomposition is stored as a property if the matrix is inversible. It is auto-updated only when needed.
  *          It allow to compute inverse, determinant and other inversion related operations more efficiently.
+ *          The decomposition is blocked by panels of `NPMATRIX_LUP_NB` columns, the rest of the matrix is updated with
+ *          the matrix product kernels, which run on `NPool` for large matrices. Panels are themselves split in halves
+ *          down to `NPMATRIX_LUP_MIN` columns.
+ *          Systems with many second members are solved at once with `m % b`, the columns of `b` being the second members.
+ *          The inverse is computed the same way, from the identity matrix.
+ *
+ *          @subsection OtherDecomp Cholesky and QR Decompositions
+ *
+ *          The Cholesky decomposition \f$ A = U^\top U \f$ of symmetric positive-definite matrices and the Householder
+ *          \f$ QR \f$ decomposition are stored and updated the same way as the \f$ LU \f$ decomposition. They are
+ *          cleared together when the components of the matrix change.
+ *          The Cholesky decomposition is split in halves recursively, the rest of the matrix being updated with matrix
+ *          products. The \f$ QR \f$ decomposition applies its reflectors to the rest of the matrix by panels of
+ *          `NPMATRIX_QR_NB`, in the form \f$ I - V T V^\top \f$, also using matrix products.
+ *          `cholSolve()` solves symmetric positive-definite systems and `qrSolve()` least squares problems.
  *
  *          @subsection FuncOp Sub-range operators
  *
@@ -86,6 +110,16 @@ public:
         copy(m);
     };
 
+    /**
+     *
+     * @param m `NPMatrix` source.
+     * @brief Construct a matrix by taking the components and the LUP decomposition of `m`.
+     * @details Only the sub-matrix is taken if browse indices of `m` are set. `m` is left empty.
+     */
+    NPMatrix(NPMatrix<T> &&m) noexcept : NPMatrix(NVector<T>(0), 0, 0) {
+        *this = std::move(m);
+    };
+
     /**
      * @param list bi-dimensional `std::initializer_list` source.
      * @brief Construct a \f$ n \times p \f$ matrix using a bi-dimensional initializer list `{{}}`.
@@ -102,6 +136,13 @@ public:
      */
     explicit NPMatrix(const NVector<T> &u, size_t n = 1) : NPMatrix(u, n, u.dim() / n) {}
 
+    /**
+     * @param u `NVector` source of size \f$ q \f$
+     * @param n number of rows formed by u
+     * @brief Construct a \f$ n \f$ rows matrix by taking the components of `u`.
+     */
+    explicit NPMatrix(NVector<T> &&u, size_t n = 1) : NPMatrix(std::move(u), n, u.dim() / n) {}
+
     /**
      * @param vectors bi-dimensional `std::vector` source.
      * @brief Construct a \f$ n \times p \f$ matrix using a `vector<NVector<T>>`.`
@@ -112,6 +153,12 @@ public:
     explicit NPMatrix(const vector<NVector<T> > &vectors) : NPMatrix(
             vector<vector<T>>(vectors.begin(), vectors.end())) {}
 
+    /**
+     * @param m `NMatrixView` source.
+     * @brief Construct a matrix by copying the components of a view.
+     */
+    explicit NPMatrix(const NMatrixView<T> &m);
+
     ~NPMatrix() { lupClear(); }
 
 
@@ -238,6 +285,24 @@ public:
      */
     NPMatrix<T> lupU() const;
 
+    /**
+     *
+     * @brief \f$ L \f$ matrix of Cholesky decomposition \f$ A = L L^\top \f$ of the matrix.
+     */
+    NPMatrix<T> cholL() const;
+
+    /**
+     *
+     * @brief \f$ Q \f$ matrix of \f$ QR \f$ decomposition of the \f$ n \times p \f$ matrix, with \f$ p \f$ orthonormal columns.
+     */
+    NPMatrix<T> qrQ() const;
+
+    /**
+     *
+     * @brief \f$ R \f$ upper triangular \f$ p \times p \f$ matrix of \f$ QR \f$ decomposition of the matrix.
+     */
+    NPMatrix<T> qrR() const;
+
     /** @} */
 
     /**
@@ -398,10 +463,21 @@ public:
 
     /**
      * @brief Transposed matrix.
+     * @details The matrix is transposed by blocks which fit in cache, using the kernels of `NBlas` for
+     * `NPMatrix<double_t>` and `NPMatrix<float>`.
      * @return Value of transposed \f$ A^\top \f$.
      */
     NPMatrix<T> transposed() const;
 
+    /**
+     * @brief Transpose this matrix in place.
+     * @details Square sub-matrices are transposed by exchanging blocks on both sides of their diagonal. Rectangular
+     * matrices are transposed by following the cycles of the permutation of their components, which requires them to
+     * be browsed entirely, and their dimensions are exchanged.
+     * @return reference to this matrix, \f$ A^\top \f$.
+     */
+    NPMatrix<T> &transpose();
+
     /**
      *
      * @brief Trace of this matrix \f$ A_{00} + A_{11} + ... + A_{(n-1)(n-1)} \f$
@@ -432,6 +508,42 @@ public:
      */
     T det() const;
 
+    /**
+     * @brief Solve the linear systems \f$ A X = B \f$ for all the columns of \f$ B \f$ at once.
+     * @details Using the \f$ LU \f$ decomposition of this matrix. The triangular systems are solved by blocks of rows,
+     * most of the work being done by matrix products. \f$ O(n^2 p) \f$.
+     * @param b second members of the systems, replaced by the solutions \f$ X \f$.
+     * @return Reference to `b`.
+     */
+    NPMatrix<T> &solve(NPMatrix<T> &b) const;
+
+    /**
+     * @brief Solve the linear system \f$ A x = u \f$ of a symmetric positive-definite matrix.
+     * @details Using the Cholesky decomposition of this matrix, only its upper triangle is read. \f$ O(n^2) \f$ once
+     * the decomposition is computed. `u` is left unchanged if the matrix isn't positive-definite.
+     * @param u second member of the system, replaced by the solution \f$ x \f$.
+     * @return Reference to `u`.
+     */
+    NVector<T> &cholSolve(NVector<T> &u) const;
+
+    /**
+     * @brief Solve the linear systems \f$ A X = B \f$ of a symmetric positive-definite matrix for all the columns of
+     * \f$ B \f$ at once.
+     * @param b second members of the systems, replaced by the solutions \f$ X \f$.
+     * @return Reference to `b`.
+     */
+    NPMatrix<T> &cholSolve(NPMatrix<T> &b) const;
+
+    /**
+     * @brief Least squares solution of \f$ A x = u \f$ where \f$ A \f$ is \f$ n \times p \f$ with \f$ n \geq p \f$.
+     * @details Using the \f$ QR \f$ decomposition of this matrix, \f$ x \f$ is the solution of
+     * \f$ R x = Q^\top u \f$ which minimizes \f$ ||A x - u|| \f$ without forming \f$ A^\top A \f$.
+     * `u` is left unchanged if the columns of the matrix are linearly dependent.
+     * @param u vector of \f$ n \f$ components, replaced by the solution \f$ x \f$ of \f$ p \f$ components.
+     * @return Reference to `u`.
+     */
+    NVector<T> &qrSolve(NVector<T> &u) const;
+
     /** @} */
 
     /**
@@ -525,6 +637,18 @@ public:
         return v;
     }
 
+    /**
+     * @param m matrix of the equation systems.
+     * @param b second members of the equation systems.
+     * @brief Solve the linear systems formed by \f$ M \f$ and each column of \f$ B \f$.
+     * @details The linear systems are \f$ MX = B \f$ where \f$ X \f$ is unknown. Using `solve(NPMatrix<T> &b)`.
+     * @return Value of the solution of the systems \f$ X \f$.
+     */
+    inline friend NPMatrix<T> operator%(const NPMatrix<T> &m, NPMatrix<T> b) {
+        b %= m;
+        return b;
+    }
+
 
     // SCALAR PRODUCT BASED OPERATIONS
 
@@ -564,6 +688,13 @@ public:
 
     inline friend NVector<T> &operator%=(NVector<T> &u, const NPMatrix<T> &m) { return m.solve(u); }
 
+    inline friend NPMatrix<T> &operator%=(NPMatrix<T> &b, const NPMatrix<T> &m) {
+        m.solve(b);
+        b.setDefaultBrowseIndices();
+        m.setDefaultBrowseIndices();
+        return b;
+    }
+
     /** @} */
 
     /**
@@ -632,6 +763,37 @@ public:
      */
     NPMatrix<T> &operator()(size_t i1, size_t j1, size_t i2, size_t j2);
 
+    /**
+     *
+     * @brief View of the sub-matrix from \f$ (i_1, j_1) \f$ to \f$ (i_2, j_2) \f$.
+     * @details The view refers to the components of the matrix and doesn't use browse indices, it can be taken
+     * from several threads at the same time. See `NMatrixView` for more details.
+     * @return view of the sub-matrix.
+     */
+    inline NMatrixView<T> view(size_t i1, size_t j1, size_t i2, size_t j2) const {
+        assert(i1 <= i2 && j1 <= j2 && isValidIndex(i2, j2));
+        return NMatrixView<T>(this->data() + vectorIndex(i1, j1), i2 - i1 + 1, j2 - j1 + 1, _p);
+    }
+
+    inline NMatrixView<T> view() const { return NMatrixView<T>(this->data(), _n, _p, _p); }
+
+    /**
+     * @brief Conversion of the components to another scalar type, eg. `mat_f_t f = m.cast<float>()`.
+     * @details The whole matrix is converted, browse indices are not used.
+     * @return a matrix with components of type `S`.
+     */
+    template<typename S>
+    NPMatrix<S> cast() const {
+        NPMatrix<S> res(_n, _p);
+        const T *x = this->data();
+        S *y = res.data();
+
+        for (size_t k = 0; k < _n * _p; ++k) {
+            y[k] = static_cast<S>(x[k]);
+        }
+        return res;
+    }
+
     /** @} */
 
     // AFFECTATION
@@ -640,6 +802,12 @@ public:
         return copy(m);
     }
 
+    /**
+     * @brief Take the components and the LUP decomposition of `m`.
+     * @details The components are copied using `copy()` if browse indices of `this` are set.
+     */
+    NPMatrix<T> &operator=(NPMatrix<T> &&m);
+
     // COMPARAISON OPERATORS
 
     friend bool operator==(const NPMatrix<T> &a, const NPMatrix<T> &b) {
@@ -758,10 +926,28 @@ public:
      */
     static NPMatrix<T> nscalar(const vector<T> &scalars, size_t n);
 
+    /**
+     * @brief Product of two views.
+     * @details The product is computed without copying the sub-matrices, using the same kernels as `operator*`.
+     * @return value of \f$ A B \f$.
+     */
+    static NPMatrix<T> product(const NMatrixView<T> &a, const NMatrixView<T> &b);
+
+    /**
+     * @brief Linear map of a view of matrix on a view of vector.
+     * @return value of \f$ A x \f$.
+     */
+    static NVector<T> product(const NMatrixView<T> &a, const NVectorView<T> &x);
+
 protected:
 
     explicit NPMatrix(const NVector<T> &u, size_t n, size_t p, size_t i1 = 0, size_t j1 = 0, size_t i2 = 0, size_t j2 = 0);
 
+    explicit NPMatrix(NVector<T> &&u, size_t n, size_t p);
+
+    // Moves out the components of the sub-matrix row by row and leaves this matrix empty
+    NStorage<T> release() override;
+
     // MANIPULATORS
 
     NPMatrix<T> &swap(Parts element, size_t k1, size_t k2);
@@ -784,6 +970,9 @@ protected:
 
     NPMatrix<T> &matrixProduct(const NPMatrix<T> &m);
 
+    // Product by a square array of the size of the browsed columns, the result is written in place
+    NPMatrix<T> &matrixProduct(const T *b, size_t ldb);
+
     inline NPMatrix<T> &add(const NPMatrix<T> &m) { return forEach(m, [](T &x, const T &y) { x += y; }); }
 
     inline NPMatrix<T> &sub(const NPMatrix<T> &m) { return forEach(m, [](T &x, const T &y) { x -= y; }); }
@@ -814,6 +1003,10 @@ protected:
 
     void lupUpdate() const;
 
+    void cholUpdate() const;
+
+    void qrUpdate() const;
+
     // MUTABLE VARIABLES MANAGEMENT
 
     inline NPMatrix<T> &clean() const {
@@ -886,9 +1079,12 @@ protected:
 
     // MANIPULATORS
 
-    NPMatrix<T> &forEach(const NPMatrix<T> &m, const function<void(T &, const T &)> &binary_op);
+    // Calls binary_op(x, y) on the components of the sub-matrices, row by row or in a single loop if rows are whole
+    template<typename Op>
+    NPMatrix<T> &forEach(const NPMatrix<T> &m, Op binary_op);
 
-    NPMatrix<T> &forEach(T s, const function<void(T &, T)> &binary_op) override;
+    template<typename Op>
+    NPMatrix<T> &forEach(T s, Op binary_op);
 
     // SIZE
 
@@ -920,15 +1116,95 @@ protected:
      * @details Represented as `unsigned long` array.
      */
     mutable unique_ptr<vector<size_t>> _perm{};
+
+    // CHOLESKY AND QR STORAGE
+
+    /**
+     * @brief Upper triangular matrix \f$ U \f$ such as \f$ U^\top U \f$ = this.
+     * @details `_chol` is `nullptr` if the decomposition isn't computed or if the matrix isn't positive-definite.
+     */
+    mutable unique_ptr<NPMatrix<T>> _chol{};
+
+    /**
+     * @brief Matrix holding \f$ R \f$ in its upper triangle and the Householder vectors \f$ v_j \f$ of \f$ Q \f$ below.
+     * @details The first component of the vectors is \f$ 1 \f$ and isn't stored.
+     */
+    mutable unique_ptr<NPMatrix<T>> _qr{};
+
+    /**
+     * @brief Factors \f$ \tau_j \f$ of the reflectors \f$ I - \tau_j v_j v_j^\top \f$ of \f$ Q \f$.
+     */
+    mutable unique_ptr<vector<T>> _tau{};
 };
 /** @} */
 
+template<typename T>
+template<typename Op>
+NPMatrix<T> &NPMatrix<T>::forEach(const NPMatrix<T> &m, Op binary_op) {
+    assert(hasSameSize(m));
+
+    size_t rows = _i2 - _i1 + 1, cols = _j2 - _j1 + 1;
+
+    // Sub-matrices made of whole rows are contiguous
+    if (cols == _p && cols == m._p) {
+        cols *= rows;
+        rows = 1;
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        T *x = this->data() + vectorIndex(i + _i1, _j1);
+        const T *y = m.data() + m.vectorIndex(i + m._i1, m._j1);
+        for (size_t j = 0; j < cols; ++j) {
+            binary_op(x[j], y[j]);
+        }
+    }
+    return cleanBoth(m);
+}
+
+template<typename T>
+template<typename Op>
+NPMatrix<T> &NPMatrix<T>::forEach(T s, Op binary_op) {
+    size_t rows = _i2 - _i1 + 1, cols = _j2 - _j1 + 1;
+
+    if (cols == _p) {
+        cols *= rows;
+        rows = 1;
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        T *x = this->data() + vectorIndex(i + _i1, _j1);
+        for (size_t j = 0; j < cols; ++j) {
+            binary_op(x[j], s);
+        }
+    }
+    return clean();
+}
+
+template<typename T>
+inline NPMatrix<T> operator*(const NMatrixView<T> &a, const NMatrixView<T> &b) { return NPMatrix<T>::product(a, b); }
+
+template<typename T>
+inline NVector<T> operator*(const NMatrixView<T> &a, const NVectorView<T> &x) { return NPMatrix<T>::product(a, x); }
+
+/**
+ * @brief Product of views of 8-bit integer matrices accumulated in 32-bit integers.
+ * @details The components of `char` matrices are read as `int8_t`. Quantized linear maps are computed by quantizing
+ * both factors with `NBlas::quantize` and converting the product back with `NBlas::dequantize`. See `NBlas` for more
+ * details.
+ * @return value of \f$ A B \f$ without overflow.
+ */
+NPMatrix<int> product8(const NMatrixView<char> &a, const NMatrixView<char> &b);
+
+NPMatrix<int> product8(const NMatrixView<uc_t> &a, const NMatrixView<char> &b);
+
 /**
  * @ingroup NAlgebra
  * @{
  * Real matrix
  */
 typedef NPMatrix<double_t> mat_t;
+/**
+ * Single precision real matrix
+ */
+typedef NPMatrix<float> mat_f_t;
 /**
  * `char` matrix
  */
@@ -0,0 +1,97 @@
+//
+// Created by bendou on 30/01/19.
+//
+
+#ifndef MATHTOOLKIT_NPOOL_H
+#define MATHTOOLKIT_NPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "thirdparty.h"
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   NPool
+ * @date    30/01/2019
+ * @author  samiBendou
+ * @brief   Persistent pool of threads running the parallel kernels of `NBlas`.
+ *
+ * @details The threads are started once and wait for work between two calls, which avoids creating threads on each
+ *          product. `run()` shares indexed tasks between the threads of the pool and the calling thread.
+ *          The tasks must write disjoint outputs, the result is then the same whatever the number of threads.
+ *
+ *          A call made while the pool is busy, from another thread or from a task, runs serially in the calling thread.
+ */
+class NPool {
+
+public:
+
+    /**
+     * @return Pool shared by the whole process, using all the hardware threads.
+     */
+    static NPool &instance();
+
+    explicit NPool(size_t threads = 0);
+
+    NPool(const NPool &) = delete;
+
+    NPool &operator=(const NPool &) = delete;
+
+    ~NPool();
+
+    /**
+     * @return Number of threads running tasks, including the calling thread.
+     */
+    inline size_t size() const { return _workers.size() + 1; }
+
+    /**
+     * @brief Restarts the pool with the given number of threads, 0 uses the hardware threads.
+     */
+    void resize(size_t threads);
+
+    /**
+     * @brief Calls task(0), ..., task(count - 1) on the threads of the pool and returns once they are all done.
+     */
+    void run(size_t count, const std::function<void(size_t)> &task);
+
+protected:
+
+    void start(size_t threads);
+
+    void stop();
+
+    void work();
+
+    // Runs tasks of the current batch until there's none left
+    void drain();
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+
+    // Held during a run, only one batch of tasks is processed at a time
+    std::mutex _busy;
+
+    std::condition_variable _wake;
+
+    std::condition_variable _done;
+
+    const std::function<void(size_t)> *_task;
+
+    size_t _count;
+
+    size_t _batch;
+
+    size_t _active;
+
+    std::atomic<size_t> _next;
+
+    bool _stop;
+};
+
+/** @} */
+
+#endif //MATHTOOLKIT_NPOOL_H
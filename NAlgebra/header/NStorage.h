@@ -0,0 +1,304 @@
+//
+// Created by bendou on 05/02/19.
+//
+
+#ifndef MATHTOOLKIT_NSTORAGE_H
+#define MATHTOOLKIT_NSTORAGE_H
+
+#include "NAllocator.h"
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+
+// Number of components stored in the object itself, larger arrays are allocated
+#define NSTORAGE_INLINE 8
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   NStorage
+ * @date    05/02/2019
+ * @author  samiBendou
+ * @brief   Array of components of vectors and matrices stored inline when it is short.
+ *
+ * @details The storage has the interface of `std::vector<T>` : iterators are pointers to the components, which are
+ *          contiguous. Arrays of at most `N` components are stored in a buffer inside the object, without any
+ *          allocation. Larger arrays are allocated by `NAllocator<T>` and aligned on `NALLOCATOR_ALIGNMENT` bytes,
+ *          they grow by doubling their capacity. The inline buffer is only aligned as `T`.
+ *
+ *          Moving an allocated storage takes its array, moving an inline storage copies its components. Pointers to
+ *          the components of an inline storage are therefore invalidated by a move.
+ *
+ *          Components are copied as bytes and never destroyed, `T` must be trivially copyable.
+ */
+template<typename T, size_t N = NSTORAGE_INLINE>
+class NStorage {
+
+    static_assert(std::is_trivially_copyable<T>::value, "components are copied as bytes");
+
+public:
+
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef NAllocator<T> allocator_type;
+
+    NStorage() : _data(buffer()), _size(0), _capacity(N) {}
+
+    explicit NStorage(size_t n) : NStorage() { resize(n); }
+
+    NStorage(size_t n, const T &x) : NStorage() { resize(n, x); }
+
+    template<typename It, typename = typename std::enable_if<!std::is_integral<It>::value>::type>
+    NStorage(It first, It last) : NStorage() { assign(first, last); }
+
+    NStorage(std::initializer_list<T> list) : NStorage(list.begin(), list.end()) {}
+
+    NStorage(const NStorage &s) : NStorage(s.begin(), s.end()) {}
+
+    NStorage(NStorage &&s) noexcept : NStorage() { take(s); }
+
+    ~NStorage() { deallocate(); }
+
+    NStorage &operator=(const NStorage &s) {
+        if (this != &s)
+            assign(s.begin(), s.end());
+        return *this;
+    }
+
+    NStorage &operator=(NStorage &&s) noexcept {
+        if (this != &s)
+            take(s);
+        return *this;
+    }
+
+    NStorage &operator=(std::initializer_list<T> list) {
+        assign(list.begin(), list.end());
+        return *this;
+    }
+
+    // GETTERS
+
+    inline size_t size() const { return _size; }
+
+    inline bool empty() const { return _size == 0; }
+
+    inline size_t capacity() const { return _capacity; }
+
+    /**
+     * @return `true` if the components are stored in the object itself.
+     */
+    inline bool isInline() const { return _data == buffer(); }
+
+    inline T *data() { return _data; }
+
+    inline const T *data() const { return _data; }
+
+    // ITERATORS
+
+    inline iterator begin() { return _data; }
+
+    inline const_iterator begin() const { return _data; }
+
+    inline iterator end() { return _data + _size; }
+
+    inline const_iterator end() const { return _data + _size; }
+
+    inline const_iterator cbegin() const { return _data; }
+
+    inline const_iterator cend() const { return _data + _size; }
+
+    inline reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+    inline const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+    inline reverse_iterator rend() { return reverse_iterator(begin()); }
+
+    inline const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    // ACCESS
+
+    inline T &operator[](size_t k) { return _data[k]; }
+
+    inline const T &operator[](size_t k) const { return _data[k]; }
+
+    inline T &at(size_t k) {
+        if (k >= _size)
+            throw std::out_of_range("NStorage::at");
+        return _data[k];
+    }
+
+    inline const T &at(size_t k) const {
+        if (k >= _size)
+            throw std::out_of_range("NStorage::at");
+        return _data[k];
+    }
+
+    inline T &front() { return _data[0]; }
+
+    inline const T &front() const { return _data[0]; }
+
+    inline T &back() { return _data[_size - 1]; }
+
+    inline const T &back() const { return _data[_size - 1]; }
+
+    // MODIFIERS
+
+    template<typename It>
+    void assign(It first, It last) {
+        size_t n = (size_t) std::distance(first, last);
+
+        if (n > _capacity) {
+            deallocate();
+            allocate(n);
+        }
+        std::uninitialized_copy(first, last, _data);
+        _size = n;
+    }
+
+    void assign(size_t n, const T &x) {
+        T y = x;
+        clear();
+        resize(n, y);
+    }
+
+    void reserve(size_t n) {
+        if (n > _capacity)
+            grow(n);
+    }
+
+    void resize(size_t n) { resize(n, T()); }
+
+    void resize(size_t n, const T &x) {
+        if (n > _capacity) {
+            T y = x;
+            grow(std::max(n, 2 * _capacity));
+            std::uninitialized_fill(_data + _size, _data + n, y);
+        } else if (n > _size) {
+            std::uninitialized_fill(_data + _size, _data + n, x);
+        }
+        _size = n;
+    }
+
+    inline void clear() { _size = 0; }
+
+    void push_back(const T &x) {
+        if (_size == _capacity) {
+            T y = x;
+            grow(2 * _capacity);
+            new(_data + _size++) T(y);
+        } else {
+            new(_data + _size++) T(x);
+        }
+    }
+
+    template<typename... Args>
+    void emplace_back(Args &&... args) { push_back(T(std::forward<Args>(args)...)); }
+
+    inline void pop_back() { _size--; }
+
+    iterator insert(const_iterator pos, const T &x) { return insert(pos, &x, &x + 1); }
+
+    template<typename It, typename = typename std::enable_if<!std::is_integral<It>::value>::type>
+    iterator insert(const_iterator pos, It first, It last) {
+        size_t k = (size_t) (pos - _data), n = (size_t) std::distance(first, last);
+        NStorage inserted(first, last);
+
+        reserve(_size + n);
+        std::memmove(_data + k + n, _data + k, (_size - k) * sizeof(T));
+        std::uninitialized_copy(inserted.begin(), inserted.end(), _data + k);
+        _size += n;
+        return _data + k;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        size_t k = (size_t) (first - _data), n = (size_t) (last - first);
+
+        std::memmove(_data + k, _data + k + n, (_size - k - n) * sizeof(T));
+        _size -= n;
+        return _data + k;
+    }
+
+    inline iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    void swap(NStorage &s) {
+        NStorage t(std::move(s));
+        s = std::move(*this);
+        *this = std::move(t);
+    }
+
+    inline void shrink_to_fit() {}
+
+    inline friend bool operator==(const NStorage &s, const NStorage &t) {
+        return s.size() == t.size() && std::equal(s.begin(), s.end(), t.begin());
+    }
+
+    inline friend bool operator!=(const NStorage &s, const NStorage &t) { return !(s == t); }
+
+protected:
+
+    inline T *buffer() { return reinterpret_cast<T *>(&_buffer); }
+
+    inline const T *buffer() const { return reinterpret_cast<const T *>(&_buffer); }
+
+    // Replaces the array, which must be inline or released, by an allocated one of n components
+    void allocate(size_t n) {
+        _data = NAllocator<T>().allocate(n);
+        _capacity = n;
+    }
+
+    void deallocate() {
+        if (!isInline())
+            NAllocator<T>().deallocate(_data, _capacity);
+        _data = buffer();
+        _capacity = N;
+    }
+
+    // Copies the components to an allocated array of n components
+    void grow(size_t n) {
+        T *data = NAllocator<T>().allocate(n);
+
+        std::uninitialized_copy(_data, _data + _size, data);
+        size_t size = _size;
+        deallocate();
+        _data = data;
+        _size = size;
+        _capacity = n;
+    }
+
+    // Takes the array of s if it is allocated, copies its components otherwise, and leaves s empty
+    void take(NStorage &s) {
+        if (s.isInline()) {
+            assign(s.begin(), s.end());
+        } else {
+            deallocate();
+            _data = s._data;
+            _size = s._size;
+            _capacity = s._capacity;
+            s._data = s.buffer();
+            s._capacity = N;
+        }
+        s._size = 0;
+    }
+
+    typename std::aligned_storage<N * sizeof(T), alignof(T)>::type _buffer;
+
+    T *_data;
+
+    size_t _size;
+
+    size_t _capacity;
+};
+
+/** @} */
+
+#endif //MATHTOOLKIT_NSTORAGE_H
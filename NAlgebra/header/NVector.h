@@ -2,6 +2,9 @@
 #define MATHTOOLKIT_VECTOR_H
 
 #include "thirdparty.h"
+#include "NExpression.h"
+#include "NView.h"
+#include "NStorage.h"
 
 #define MAX_SIZE 4294967295
 #define EPSILON (std::numeric_limits<T>::epsilon())
@@ -16,11 +19,13 @@
  *
  * @brief   A `NVector<T>` object represents the coordinates of a finite dimension dense vector \f$ x \f$.
  *
- * @details Coordinates are stored in the form `[` \f$ x_0, x_1, ..., x_{(n-1)} \f$ `]`. where `[...]` is a `std::vector<T>`,
+ * @details Coordinates are stored in the form `[` \f$ x_0, x_1, ..., x_{(n-1)} \f$ `]`. where `[...]` is a `NStorage<T>`,
  *          \f$ n \f$ is the dimension and \f$ (x_0, x_1, ..., x_{(n-1)}) \f$ are the coordinates.
  *
- *          This object inherits from `std::vector<T>`, it is a STL container, iterators and STL library functions can be
- *          used.
+ *          This object inherits from `NStorage<T>`, a container with the interface of `std::vector<T>`. Vectors of at
+ *          most `NSTORAGE_INLINE` components are stored inside the object and don't allocate, larger ones are aligned
+ *          on a cache line by `NAllocator<T>`. It is a STL container, iterators and STL library functions can be used.
+ *          Vectors are converted to and from `std::vector<T>` by copying their components.
  *
  *          @section Features
  *
@@ -47,11 +52,11 @@
 template<typename T>
 
 
-class NVector : public std::vector<T> {
+class NVector : public NStorage<T> {
 
-    typedef typename std::vector<T>::iterator iterator;
+    typedef typename NStorage<T>::iterator iterator;
 
-    typedef typename std::vector<T>::const_iterator const_iterator;
+    typedef typename NStorage<T>::const_iterator const_iterator;
 
 
 public:
@@ -60,20 +65,26 @@ public:
      * @param data `std::vector` source.
      * @brief Construct a vector using a `std::vector`. \f$ x_k \f$ represents `data[k]`.
      */
-    NVector(const std::vector<T> &data) : NVector(data, 0, 0) {}
+    NVector(const std::vector<T> &data) : NVector(NStorage<T>(data.begin(), data.end()), 0, 0) {}
+
+    /**
+     * @param data `NStorage` source.
+     * @brief Construct a vector by taking the components of `data` without copying them.
+     */
+    NVector(NStorage<T> &&data) : NVector(std::move(data), 0, 0) {}
 
     /**
      * @param list `std::initializer_list` source.
      * @brief Construct a vector using an initializer list `{}`.
      * @details Convert `list` and uses @ref NVector(const std::vector<T> &data) "array constructor".
      */
-    NVector(std::initializer_list<T> list) : NVector(std::vector<T>(list)) {}
+    NVector(std::initializer_list<T> list) : NVector(NStorage<T>(list)) {}
 
     /**
      * @param dim vector size
      * @brief Construct a vector of a given size.
      */
-    explicit NVector(size_t dim = 0) : NVector(std::vector<T>((size_t) dim), 0, 0) {}
+    explicit NVector(size_t dim = 0) : NVector(NStorage<T>((size_t) dim), 0, 0) {}
 
     /**
      *
@@ -82,6 +93,21 @@ public:
      */
     NVector(const NVector<T> &u) : NVector(0) { copy(u); }
 
+    /**
+     *
+     * @param u `NVector` source.
+     * @brief Construct a vector by taking the components of `u`.
+     * @details Only the sub-vector is taken if browse indices of `u` are set. `u` is left empty.
+     */
+    NVector(NVector<T> &&u) noexcept : NStorage<T>(u.release()), _k1(0), _k2(0) { setDefaultBrowseIndices(); }
+
+    /**
+     * @param e expression source.
+     * @brief Construct a vector by computing an expression such as `u + s * v`.
+     */
+    template<typename E>
+    NVector(const NExpr<E, T> &e) : NVector(e.dim()) { assign(e); }
+
     virtual ~NVector() = default;
 
     // SERIALIZATION
@@ -112,13 +138,33 @@ public:
      */
     std::vector<T> array() const;
 
+    /**
+     * @brief Copy of all the components in a `std::vector`, whatever the browse indices.
+     */
+    inline operator std::vector<T>() const { return std::vector<T>(NStorage<T>::begin(), NStorage<T>::end()); }
+
     /**
      *
      * @name Extremums
-     * @brief Methods related to maximum minimum value research. They all use `std::max` or `std::min`.
+     * @brief Methods related to maximum minimum value research. The minimum and the maximum are searched together in a
+     * single pass, vectorized for `double_t` and `float` vectors. Indices are the ones of the first extremums found.
      * @{
      */
 
+    /**
+     *
+     * @brief Minimum and maximum of the coordinates of the vector \f$ (x_0, x_1, .. x_{(n-1)}) \f$.
+     * @return pair (min, max)
+     */
+    std::pair<T, T> minmax() const;
+
+    /**
+     *
+     * @brief Indices of the minimum and of the maximum of the coordinates of the vector.
+     * @return pair of indices (argmin, argmax)
+     */
+    std::pair<size_t, size_t> minmaxIndex() const;
+
     /**
      *
      * @brief Maximum of the coordinates of the vector \f$ (x_0, x_1, .. x_{(n-1)}) \f$.
@@ -175,8 +221,24 @@ public:
      */
     size_t minAbsIndex() const;
 
+    /**
+     *
+     * @brief Indices of the minimum and of the maximum of the coordinates of vector \f$ (|x_0|, |x_1|, ..., |x_{(n-1)}|) \f$.
+     * @return pair of indices (argmin, argmax)
+     */
+    std::pair<size_t, size_t> minmaxAbsIndex() const;
+
     /** @} */
 
+    /**
+     *
+     * @brief Sum of the coordinates of the vector \f$ x_0 + x_1 + ... + x_{(n-1)} \f$.
+     * @details `double_t` and `float` vectors are summed pairwise by blocks, the result doesn't depend on the number
+     * of threads.
+     * @return value of the sum
+     */
+    T sum() const;
+
     /**
      * @name Manipulators
      * @brief Manipulators such as swap, shift...
@@ -219,58 +281,7 @@ public:
      * @{
      */
 
-    /**
-     * @brief Add two vectors.
-     * @details Using usual addition \f$ (u_0 + v_0, u_1 + v_1, ...) \f$.
-     * @return value of \f$ u + v \f$
-     */
-    inline friend NVector<T> operator+(NVector<T> u, const NVector<T> &v) {
-        u += v;
-        return u;
-    }
-
-    /**
-     * @brief Substract two vectors.
-     * @details Using usual difference \f$ (u_0 - v_0, u_1 - v_1, ...) \f$.
-     * @return value of \f$ u - v \f$
-     */
-    inline friend NVector<T> operator-(NVector<T> u, const NVector<T> &v) {
-        u -= v;
-        return u;
-    }
-
-    /**
-     * @brief Opposite of vector.
-     * @return value of \f$ (-u_0, -u_1, ...). \f$
-     */
-    inline friend NVector<T> operator-(NVector<T> u) {
-        u.opp();
-        return u;
-    }
-
-    /**
-     * @brief Multiply vector by scalar.
-     * @details Using usual scalar multiplication difference \f$ (s \cdot u_0, s \cdot u_1, ...) \f$.
-     * @return value of \f$ s \cdot u \f$
-     */
-    inline friend NVector<T> operator*(T s, NVector<T> u) {
-        u *= s;
-        return u;
-    }
-
-    inline friend NVector<T> operator*(const NVector<T> &u, T s) {
-        return s * u;
-    }
-
-    /**
-     * @brief Divide vector by scalar.
-     * @details Usual scalar division based on multiplication.
-     * @return value of \f$ s^{-1} \cdot u \f$
-     */
-    inline friend NVector<T> operator/(NVector<T> u, T s) {
-        u /= s;
-        return u;
-    }
+    // Sum, difference, opposite and scalar products of vectors are expressions, see NExpression.h
 
     /**
      * @brief Dot product of two vectors.
@@ -299,6 +310,12 @@ public:
 
     inline NVector<T> &operator-=(const NVector<T> &u) { return sub(u); }
 
+    template<typename E>
+    inline NVector<T> &operator+=(const NExpr<E, T> &e) { return update<NAdd>(e); }
+
+    template<typename E>
+    inline NVector<T> &operator-=(const NExpr<E, T> &e) { return update<NSub>(e); }
+
     inline virtual NVector<T> &operator*=(T s) { return prod(s); }
 
     inline virtual NVector<T> &operator/=(T s) { return div(s); }
@@ -353,6 +370,37 @@ public:
      */
     NVector<T> &operator()(size_t k1, size_t k2);
 
+    /**
+     *
+     * @param k1 first element to take
+     * @param k2 last element to take \f$ n \gt k_2 \geq k_1 \geq 0 \f$
+     * @brief View of the sub-vector \f$ (x_{k_1}, x_{(k_1+1)}, ...,x_{k_2}) \f$.
+     * @details The view refers to the components of the vector and doesn't use browse indices, it can be taken
+     * from several threads at the same time. See `NVectorView` for more details.
+     * @return view of the sub-vector.
+     */
+    inline NVectorView<T> view(size_t k1, size_t k2) const {
+        assert(k1 <= k2 && isValidIndex(k2));
+        return NVectorView<T>(this->data() + k1, k2 - k1 + 1);
+    }
+
+    inline NVectorView<T> view() const { return NVectorView<T>(this->data(), this->size()); }
+
+    /**
+     * @brief Conversion of the components to another scalar type, eg. `vec_f_t v = u.cast<float>()`.
+     * @details The whole vector is converted, browse indices are not used.
+     * @return a vector with components of type `S`.
+     */
+    template<typename S>
+    NVector<S> cast() const {
+        std::vector<S> data(this->size());
+
+        for (size_t k = 0; k < data.size(); ++k) {
+            data[k] = static_cast<S>((*this)[k]);
+        }
+        return NVector<S>(std::move(data));
+    }
+
     /** @} */
 
 
@@ -382,6 +430,24 @@ public:
      */
     inline NVector<T> &operator=(const NVector<T> &u) { return copy(u); }
 
+    /**
+     * @param u source `NVector<T>` object
+     * @brief Take the components of source object.
+     * @details The components are copied using `copy()` if browse indices of `this` are set, so that they are
+     * only written in the sub-vector.
+     * @return reference to `this`.
+     */
+    NVector<T> &operator=(NVector<T> &&u);
+
+    /**
+     * @param e source expression
+     * @brief Computes the expression in a single loop.
+     * @details If browse indices are set, the expression is only written in the sub-vector.
+     * @return reference to `this`.
+     */
+    template<typename E>
+    inline NVector<T> &operator=(const NExpr<E, T> &e) { return assign(e); }
+
     // NORM BASED COMPARISON OPERATORS
 
 
@@ -431,13 +497,13 @@ public:
      * @brief Similar iterators as `std::vector` except that they allow use of `operator()()`.
      * @{
      */
-    inline iterator begin() { return this->std::vector<T>::begin() + _k1; };
+    inline iterator begin() { return this->NStorage<T>::begin() + _k1; };
 
-    inline const_iterator begin() const { return this->std::vector<T>::begin() + _k1; };
+    inline const_iterator begin() const { return this->NStorage<T>::begin() + _k1; };
 
-    inline iterator end() { return this->std::vector<T>::begin() + _k2 + 1; };
+    inline iterator end() { return this->NStorage<T>::begin() + _k2 + 1; };
 
-    inline const_iterator end() const { return this->std::vector<T>::begin() + _k2 + 1; };
+    inline const_iterator end() const { return this->NStorage<T>::begin() + _k2 + 1; };
 
     /** @} */
 
@@ -511,7 +577,12 @@ public:
 
 protected:
 
-    explicit NVector(const std::vector<T> &data, size_t k1, size_t k2);
+    explicit NVector(const NStorage<T> &data, size_t k1, size_t k2);
+
+    explicit NVector(NStorage<T> &&data, size_t k1, size_t k2);
+
+    // Moves out the components of the sub-vector and leaves this vector empty
+    virtual NStorage<T> release();
 
     // VECTOR SPACE OPERATIONS
 
@@ -532,7 +603,7 @@ protected:
     inline T norm() const { return sqrt(dotProduct(*this)); }
 
     inline T distance(const NVector<T> &u) const {
-        T d = (*this - u).norm();
+        T d = !(*this - u);
         setDefaultBrowseIndices();
         u.setDefaultBrowseIndices();
         return d;
@@ -553,22 +624,62 @@ protected:
 
     inline virtual bool hasDefaultBrowseIndices() const { return _k1 == 0 && (_k2 == this->size() - 1 || _k2 == 0); }
 
+    // Indices are only written when they are set, so that concurrent calls of const methods don't write the vector
     inline virtual void setDefaultBrowseIndices() const {
-        _k1 = 0;
-        _k2 = (!this->empty()) ? this->size() - 1 : 0;
+        size_t k2 = (!this->empty()) ? this->size() - 1 : 0;
+
+        if (_k1 != 0 || _k2 != k2) {
+            _k1 = 0;
+            _k2 = k2;
+        }
     }
 
     // MANIPULATORS
 
-    NVector<T> &forEach(const NVector<T> &u, const std::function<void(T &, const T &)> &binary_op);
+    // Calls binary_op(x, y) on the components of the sub-vectors, the callable is inlined in the loop
+    template<typename Op>
+    NVector<T> &forEach(const NVector<T> &u, Op binary_op);
 
-    virtual NVector<T> &forEach(T s, const std::function<void(T &, T)> &binary_op);
+    template<typename Op>
+    NVector<T> &forEach(T s, Op binary_op);
 
 
     // AFFECTATION
 
     NVector<T> &copy(const NVector<T> &u);
 
+    template<typename E>
+    NVector<T> &assign(const NExpr<E, T> &e) {
+        if (hasDefaultBrowseIndices() && this->size() != e.dim()) {
+            this->resize(e.dim());
+            setDefaultBrowseIndices();
+        }
+        return update<NSet>(e);
+    }
+
+    // Applies the operation to the components of the sub-vector and the expression
+    template<typename Op, typename E>
+    NVector<T> &update(const NExpr<E, T> &e) {
+        size_t dim = this->empty() ? 0 : _k2 - _k1 + 1;
+        T *dst = this->data() + _k1;
+
+        assert(dim == e.dim());
+        if (e.aliases(dst, dim)) {
+            // The operands overlap the result with a shift, computing them aside
+            NVector<T> res{e};
+            return update<Op>(NLeaf<T>(res));
+        }
+        for (size_t k = 0; k < dim; ++k) {
+            dst[k] = Op::apply(dst[k], e[k]);
+        }
+        setDefaultBrowseIndices();
+        return *this;
+    }
+
+    struct NSet {
+        static inline T apply(const T &, const T &y) { return y; }
+    };
+
     //SUB-VECTORS
 
     NVector<T> subVector(size_t k1, size_t k2) const;
@@ -577,6 +688,8 @@ protected:
 
     //BROWSE INDICES
 
+    friend class NLeaf<T>;
+
     mutable size_t _k1{};
 
     mutable size_t _k2{};
@@ -585,6 +698,40 @@ protected:
 template <>
 inline double_t NVector<double_t>::norm() const { return std::sqrt(dotProduct(*this)); }
 
+template<typename T>
+template<typename Op>
+NVector<T> &NVector<T>::forEach(const NVector<T> &u, Op binary_op) {
+    assert(hasSameSize(u));
+
+    // Sub-vectors are contiguous, the loop is vectorized for simple operations
+    size_t dim = this->empty() ? 0 : _k2 - _k1 + 1;
+    T *x = this->data() + _k1;
+    const T *y = u.data() + u._k1;
+    for (size_t k = 0; k < dim; ++k) {
+        binary_op(x[k], y[k]);
+    }
+    setDefaultBrowseIndices();
+    u.setDefaultBrowseIndices();
+    return *this;
+}
+
+template<typename T>
+template<typename Op>
+NVector<T> &NVector<T>::forEach(T s, Op binary_op) {
+    size_t dim = this->empty() ? 0 : _k2 - _k1 + 1;
+    T *x = this->data() + _k1;
+    for (size_t k = 0; k < dim; ++k) {
+        binary_op(x[k], s);
+    }
+    setDefaultBrowseIndices();
+    return *this;
+}
+
+template<typename T>
+NLeaf<T>::NLeaf(const NVector<T> &u) : _data(u.data() + u._k1), _dim(u.empty() ? 0 : u._k2 - u._k1 + 1) {
+    u.setDefaultBrowseIndices();
+}
+
 /** @} */
 
 /**
@@ -594,6 +741,11 @@ inline double_t NVector<double_t>::norm() const { return std::sqrt(dotProduct(*t
  */
 typedef NVector<double_t> vec_t;
 
+/**
+ * Single precision real vector
+ */
+typedef NVector<float> vec_f_t;
+
 /**
  * `char` vector
  */
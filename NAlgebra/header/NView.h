@@ -0,0 +1,172 @@
+//
+// Created by bendou on 01/02/19.
+//
+
+#ifndef MATHTOOLKIT_NVIEW_H
+#define MATHTOOLKIT_NVIEW_H
+
+#include "NExpression.h"
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   NVectorView
+ * @date    01/02/2019
+ * @author  samiBendou
+ * @brief   Read only range of components of a vector or a matrix, without copy.
+ *
+ * @details A view is made of a pointer to the first component, a dimension and a stride, the distance between two
+ *          components. Rows of a matrix are views of stride 1 and columns views of stride `p`.
+ *
+ *          Unlike browse indices, views don't modify the object they refer to. Many threads can take and read views
+ *          of the same vector at the same time. A view refers to the components of its source, it is invalidated
+ *          when the source is resized or destroyed.
+ *
+ *          Views are expressions, they can be used as operands of the algebraical operators of `NVector` and are
+ *          copied into a vector with `NVector<T> u = view`.
+ */
+template<typename T>
+class NVectorView : public NExpr<NVectorView<T>, T> {
+
+public:
+
+    NVectorView(const T *data, size_t dim, size_t stride = 1) : _data(data), _dim(dim), _stride(stride) {}
+
+    inline const T *data() const { return _data; }
+
+    inline size_t dim() const { return _dim; }
+
+    inline size_t stride() const { return _stride; }
+
+    inline T operator[](size_t k) const { return _data[k * _stride]; }
+
+    inline T operator()(size_t k) const {
+        assert(k < _dim);
+        return _data[k * _stride];
+    }
+
+    /**
+     * @brief View of the components \f$ k_1 \f$ to \f$ k_2 \f$ of this view.
+     */
+    inline NVectorView<T> view(size_t k1, size_t k2) const {
+        assert(k1 <= k2 && k2 < _dim);
+        return NVectorView<T>(_data + k1 * _stride, k2 - k1 + 1, _stride);
+    }
+
+    // Only a view reading the written components in the same order is safe
+    inline bool aliases(const T *dst, size_t n) const {
+        if (_dim == 0 || (_data == dst && _stride == 1))
+            return false;
+        return _data < dst + n && dst <= _data + (_dim - 1) * _stride;
+    }
+
+protected:
+
+    const T *_data;
+
+    size_t _dim;
+
+    size_t _stride;
+};
+
+/**
+ * @brief Order in which the components of a matrix are stored.
+ * @details `RowMajor` stores the component (i, j) at `i * ld + j` and `ColMajor` at `j * ld + i`, `ld` being the
+ *          leading dimension of the storage.
+ */
+enum NLayout {
+    RowMajor,
+    ColMajor
+};
+
+/**
+ * @class   NMatrixView
+ * @date    01/02/2019
+ * @author  samiBendou
+ * @brief   Read only sub-matrix of a row-major or column-major matrix, without copy.
+ *
+ * @details A view is made of a pointer to its first component, its size \f$ n \times p \f$, the leading dimension
+ *          of the source, the distance between two rows or two columns, and the layout of the source. As for
+ *          `NVectorView`, views can be taken and read concurrently and are invalidated when their source is resized
+ *          or destroyed.
+ *
+ *          Column-major views wrap buffers of other libraries as they are. They are also used to transpose a view
+ *          without moving its components, `view.transposed()` referring to the same storage with the other layout.
+ *
+ *          Views of matrices of `NPMatrix<T>` can be multiplied with `*` and copied into a matrix with
+ *          `NPMatrix<T> m(view)`, whatever their layout.
+ */
+template<typename T>
+class NMatrixView {
+
+public:
+
+    NMatrixView(const T *data, size_t n, size_t p, size_t ld, NLayout layout = RowMajor) :
+            _data(data), _n(n), _p(p), _ld(ld), _layout(layout) {}
+
+    inline const T *data() const { return _data; }
+
+    inline size_t n() const { return _n; }
+
+    inline size_t p() const { return _p; }
+
+    inline size_t ld() const { return _ld; }
+
+    inline NLayout layout() const { return _layout; }
+
+    /**
+     * @return distance between the components (i, j) and (i + 1, j).
+     */
+    inline size_t rowStride() const { return _layout == RowMajor ? _ld : 1; }
+
+    /**
+     * @return distance between the components (i, j) and (i, j + 1).
+     */
+    inline size_t colStride() const { return _layout == RowMajor ? 1 : _ld; }
+
+    inline T operator()(size_t i, size_t j) const {
+        assert(i < _n && j < _p);
+        return _data[i * rowStride() + j * colStride()];
+    }
+
+    inline NVectorView<T> row(size_t i) const {
+        assert(i < _n);
+        return NVectorView<T>(_data + i * rowStride(), _p, colStride());
+    }
+
+    inline NVectorView<T> col(size_t j) const {
+        assert(j < _p);
+        return NVectorView<T>(_data + j * colStride(), _n, rowStride());
+    }
+
+    /**
+     * @brief View of the sub-matrix from \f$ (i_1, j_1) \f$ to \f$ (i_2, j_2) \f$ of this view.
+     */
+    inline NMatrixView<T> view(size_t i1, size_t j1, size_t i2, size_t j2) const {
+        assert(i1 <= i2 && i2 < _n && j1 <= j2 && j2 < _p);
+        return NMatrixView<T>(_data + i1 * rowStride() + j1 * colStride(), i2 - i1 + 1, j2 - j1 + 1, _ld, _layout);
+    }
+
+    /**
+     * @return view of the transposed matrix, in \f$ O(1) \f$.
+     */
+    inline NMatrixView<T> transposed() const {
+        return NMatrixView<T>(_data, _p, _n, _ld, _layout == RowMajor ? ColMajor : RowMajor);
+    }
+
+protected:
+
+    const T *_data;
+
+    size_t _n;
+
+    size_t _p;
+
+    size_t _ld;
+
+    NLayout _layout;
+};
+
+/** @} */
+
+#endif //MATHTOOLKIT_NVIEW_H
@@ -1,7 +1,7 @@
 #ifndef MATHTOOLKIT_VECTOR3_H
 #define MATHTOOLKIT_VECTOR3_H
 
-#include <NVector.h>
+#include <NFixed.h>
 
 /**
  * @ingroup NAlgebra
@@ -41,26 +41,28 @@
  *            setting components generally implies a constant time calculation to translate between cartesian
  *            and other formats.
  *
- *            The `Vector3` class doesn't support function operator `NVector::operator()()`.
+ *            The components are stored in place by `NFixedVector`, so vectors are created without allocation and
+ *            all the cartesian operations are `constexpr`. Vectors are converted from a `NVector<double_t>` of 3
+ *            components with the explicit constructor and to a `NVector<double_t>` with `array()`.
  *
  */
 
-class Vector3 : public NVector<double_t> {
+class Vector3 : public NFixedVector<double_t, 3> {
 public:
 
-    using NVector::operator=;
+    constexpr explicit Vector3(double_t x = 0, double_t y = 0, double_t z = 0) : NFixedVector(x, y, z) {}
 
-    using NVector::NVector;
+    constexpr Vector3(const NFixedVector<double_t, 3> &u) : NFixedVector(u) {}
 
-    explicit Vector3(double_t x = 0, double_t y = 0, double_t z = 0) : NVector(3) { setXYZ(x, y, z); }
+    explicit Vector3(const NVector<double_t> &u) : NFixedVector(u) {}
 
     //3D COORDINATES GETTERS
 
-    inline double_t x() const { return (*this)[0]; }
+    constexpr double_t x() const { return _data[0]; }
 
-    inline double_t y() const { return (*this)[1]; }
+    constexpr double_t y() const { return _data[1]; }
 
-    inline double_t z() const { return (*this)[2]; }
+    constexpr double_t z() const { return _data[2]; }
 
     inline double_t r() const { return !(*this); };
 
@@ -68,15 +70,15 @@ public:
 
     inline double_t phi() const { return atan2((double)!rXY(), (double)z()); }
 
-    inline Vector3 rXY() const { return Vector3(x(), y(), 0); }
+    constexpr Vector3 rXY() const { return Vector3(x(), y(), 0); }
 
     //3D COORDINATES SETTERS
 
-    inline void setX(double_t scalar) { (*this)[0] = scalar; }
+    inline void setX(double_t scalar) { _data[0] = scalar; }
 
-    inline void setY(double_t scalar) { (*this)[1] = scalar; }
+    inline void setY(double_t scalar) { _data[1] = scalar; }
 
-    inline void setZ(double_t scalar) { (*this)[2] = scalar; }
+    inline void setZ(double_t scalar) { _data[2] = scalar; }
 
     inline void setR(double_t scalar) { setRThetaPhi(scalar, theta(), phi()); }
 
@@ -85,9 +87,9 @@ public:
     inline void setPhi(double_t scalar) { setRThetaPhi(r(), theta(), scalar); }
 
     inline void setXYZ(double_t x, double_t y, double_t z) {
-        (*this)[0] = x;
-        (*this)[1] = y;
-        (*this)[2] = z;
+        _data[0] = x;
+        _data[1] = y;
+        _data[2] = z;
     };
 
     inline void setRThetaZ(double_t r, double_t theta, double_t z) {
@@ -102,41 +104,26 @@ public:
                r * cos((double) phi));
     }
 
-    inline friend Vector3 operator+(Vector3 u, const Vector3 &v) {
-        u += v;
-        return u;
+    inline friend constexpr Vector3 operator+(const Vector3 &u, const Vector3 &v) {
+        return Vector3(u.x() + v.x(), u.y() + v.y(), u.z() + v.z());
     }
 
-    inline friend Vector3 operator-(Vector3 u, const Vector3 &v) {
-        u -= v;
-        return u;
+    inline friend constexpr Vector3 operator-(const Vector3 &u, const Vector3 &v) {
+        return Vector3(u.x() - v.x(), u.y() - v.y(), u.z() - v.z());
     }
 
-    inline friend Vector3 operator-(Vector3 u) {
-        u.opp();
-        return u;
-    }
+    inline friend constexpr Vector3 operator-(const Vector3 &u) { return Vector3(-u.x(), -u.y(), -u.z()); }
 
-    inline friend Vector3 operator*(double_t s, Vector3 u) {
-        u *= s;
-        return u;
+    inline friend constexpr Vector3 operator*(double_t s, const Vector3 &u) {
+        return Vector3(s * u.x(), s * u.y(), s * u.z());
     }
 
-    inline friend Vector3 operator*(const Vector3 &u, double_t s) {
-        return s * u;
-    }
+    inline friend constexpr Vector3 operator*(const Vector3 &u, double_t s) { return s * u; }
 
-    inline friend Vector3 operator/(Vector3 u, double_t s) {
-        u /= s;
-        return u;
+    inline friend constexpr Vector3 operator/(const Vector3 &u, double_t s) {
+        return Vector3(u.x() / s, u.y() / s, u.z() / s);
     }
 
-    inline friend double_t operator|(const Vector3 &u, const Vector3 &v) { return u.dotProduct(v); }
-
-    inline friend double_t operator!(const Vector3 &u) { return u.norm(); }
-
-    inline friend double_t operator/(const Vector3 &u, const Vector3 &v) { return u.distance(v); }
-
     /**
      * @brief Vector product between two us
      * @details usual u product given by :
@@ -151,9 +138,10 @@ public:
      *
      * @return value of \f$ \vec{u} \times \vec{v} \f$.
      */
-    inline friend Vector3 operator^(Vector3 u, const Vector3 &v) {
-        u ^= v;
-        return u;
+    inline friend constexpr Vector3 operator^(const Vector3 &u, const Vector3 &v) {
+        return Vector3(u.y() * v.z() - u.z() * v.y(),
+                       u.z() * v.x() - u.x() * v.z(),
+                       u.x() * v.y() - u.y() * v.x());
     }
 
     /**
@@ -163,24 +151,18 @@ public:
     inline friend double_t operator%(const Vector3 &u, const Vector3 &v) {return u.angle(v);}
 
 
-    inline Vector3& operator ^=(const Vector3 &u) {return cross(u);}
+    inline Vector3& operator ^=(const Vector3 &u) {return *this = *this ^ u;}
 
-    inline static Vector3 zeros() {return Vector3(NVector::zeros(3));}
+    constexpr static Vector3 zeros() {return Vector3();}
 
-    inline static Vector3 ones() {return Vector3(NVector::ones(3));}
+    constexpr static Vector3 ones() {return Vector3(1, 1, 1);}
 
-    inline static Vector3 scalar(double_t scalar) {return Vector3(NVector::scalar(scalar, 3));}
+    constexpr static Vector3 scalar(double_t scalar) {return Vector3(scalar, scalar, scalar);}
 
-    inline static Vector3 cano(size_t k) {return Vector3(NVector::cano(k, 3));}
+    constexpr static Vector3 cano(size_t k) {return Vector3(NFixedVector::cano(k));}
 
 
 protected:
-    Vector3& cross(const Vector3 &u) {
-        setXYZ(y() * u.z() - z() * u.y(),
-               z() * u.x() - x() * u.z(),
-               x() * u.y() - y() * u.x());
-        return *this;
-    }
 
     inline double_t angle(const Vector3 &u) const {return atan((double) pTan(u));}
 
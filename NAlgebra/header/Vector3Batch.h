@@ -0,0 +1,224 @@
+//
+// Created by bendou on 03/02/19.
+//
+
+#ifndef MATHTOOLKIT_VECTOR3BATCH_H
+#define MATHTOOLKIT_VECTOR3BATCH_H
+
+#include <Vector3.h>
+
+typedef NFixedMatrix<double_t, 3> Matrix3;
+
+/**
+ * @ingroup NAlgebra
+ * @{
+ * @class   Vector3Batch
+ * @date    03/02/2019
+ * @author  samiBendou
+ * @brief   Array of 3D vectors stored component by component.
+ *
+ * @details The components x, y and z of the vectors are stored in three separate arrays. Operations on whole batches
+ *          load 4 vectors at a time in the lanes of AVX2 registers instead of a single `Vector3` at a time. They are
+ *          element-wise : the k-th vector of the result only depends on the k-th vectors of the operands.
+ *
+ *          @code{.cpp}
+ *          Vector3Batch u{Vector3(1, 0, 0), Vector3(0, 1, 0)}, v = Vector3Batch::ones(2);
+ *          std::cout << (u | v); // displays "( 1 1 )"
+ *          @endcode
+ *
+ *          The operators allocate their result. The static bulk functions `dot`, `cross`, `norm`, `scale`, `theta`,
+ *          `phi` and `apply` write it to an existing array or batch, which can be one of the operands. They are meant
+ *          to be used in loops on large arrays of vectors.
+ *
+ *          Angles are computed one vector at a time with `atan2`, the other operations with AVX2 and FMA instructions
+ *          when they are available.
+ */
+class Vector3Batch {
+
+public:
+
+    /**
+     * @brief Construct a batch of `size` null vectors.
+     */
+    explicit Vector3Batch(size_t size = 0);
+
+    /**
+     * @brief Construct a batch from an array of vectors.
+     */
+    explicit Vector3Batch(const std::vector<Vector3> &vectors);
+
+    Vector3Batch(std::initializer_list<Vector3> list);
+
+    // GETTERS
+
+    inline size_t size() const { return _x.size(); }
+
+    inline const double_t *x() const { return _x.data(); }
+
+    inline double_t *x() { return _x.data(); }
+
+    inline const double_t *y() const { return _y.data(); }
+
+    inline double_t *y() { return _y.data(); }
+
+    inline const double_t *z() const { return _z.data(); }
+
+    inline double_t *z() { return _z.data(); }
+
+    std::vector<Vector3> vectors() const;
+
+    std::string str() const;
+
+    inline friend std::ostream &operator<<(std::ostream &os, const Vector3Batch &u) { return os << u.str(); }
+
+    // SETTERS
+
+    void resize(size_t size);
+
+    void push_back(const Vector3 &u);
+
+    inline void set(size_t k, const Vector3 &u) {
+        assert(k < size());
+        _x[k] = u.x();
+        _y[k] = u.y();
+        _z[k] = u.z();
+    }
+
+    // ACCESS
+
+    inline Vector3 operator[](size_t k) const {
+        assert(k < size());
+        return Vector3(_x[k], _y[k], _z[k]);
+    }
+
+    // COORDINATES
+
+    vec_t r() const { return !(*this); }
+
+    vec_t theta() const;
+
+    vec_t phi() const;
+
+    // OPERATORS
+
+    inline friend Vector3Batch operator+(Vector3Batch u, const Vector3Batch &v) { return u += v; }
+
+    inline friend Vector3Batch operator-(Vector3Batch u, const Vector3Batch &v) { return u -= v; }
+
+    inline friend Vector3Batch operator-(Vector3Batch u) { return u *= -1; }
+
+    inline friend Vector3Batch operator*(double_t s, Vector3Batch u) { return u *= s; }
+
+    inline friend Vector3Batch operator*(Vector3Batch u, double_t s) { return u *= s; }
+
+    inline friend Vector3Batch operator/(Vector3Batch u, double_t s) { return u /= s; }
+
+    /**
+     * @return Batch of the images of the vectors of u by the matrix m.
+     */
+    inline friend Vector3Batch operator*(const Matrix3 &m, Vector3Batch u) {
+        apply(m, u, u);
+        return u;
+    }
+
+    /**
+     * @return Batch of the cross products of the vectors of u and v.
+     */
+    inline friend Vector3Batch operator^(Vector3Batch u, const Vector3Batch &v) { return u ^= v; }
+
+    /**
+     * @return Array of the dot products of the vectors of u and v.
+     */
+    friend vec_t operator|(const Vector3Batch &u, const Vector3Batch &v);
+
+    /**
+     * @return Array of the norms of the vectors of u.
+     */
+    friend vec_t operator!(const Vector3Batch &u);
+
+    Vector3Batch &operator+=(const Vector3Batch &u);
+
+    Vector3Batch &operator-=(const Vector3Batch &u);
+
+    inline Vector3Batch &operator*=(double_t s) {
+        scale(*this, s, *this);
+        return *this;
+    }
+
+    inline Vector3Batch &operator/=(double_t s) { return *this *= 1 / s; }
+
+    inline Vector3Batch &operator^=(const Vector3Batch &u) {
+        cross(*this, u, *this);
+        return *this;
+    }
+
+    // BULK FUNCTIONS
+
+    /**
+     * @brief Dot products of the vectors of u and v.
+     * @details r must have `u.size()` components.
+     */
+    static void dot(const Vector3Batch &u, const Vector3Batch &v, double_t *r);
+
+    /**
+     * @brief Cross products of the vectors of u and v.
+     * @details r must have the size of u, it can be u or v.
+     */
+    static void cross(const Vector3Batch &u, const Vector3Batch &v, Vector3Batch &r);
+
+    /**
+     * @brief Norms of the vectors of u.
+     * @details r must have `u.size()` components.
+     */
+    static void norm(const Vector3Batch &u, double_t *r);
+
+    /**
+     * @brief Vectors of u multiplied by s.
+     * @details r must have the size of u, it can be u.
+     */
+    static void scale(const Vector3Batch &u, double_t s, Vector3Batch &r);
+
+    /**
+     * @brief Vectors of u multiplied by the components of s.
+     * @details s and r must have `u.size()` components, r can be u.
+     */
+    static void scale(const Vector3Batch &u, const double_t *s, Vector3Batch &r);
+
+    /**
+     * @brief Angles \f$ \theta \f$ of the vectors of u.
+     * @details r must have `u.size()` components.
+     */
+    static void theta(const Vector3Batch &u, double_t *r);
+
+    /**
+     * @brief Angles \f$ \phi \f$ of the vectors of u.
+     * @details r must have `u.size()` components.
+     */
+    static void phi(const Vector3Batch &u, double_t *r);
+
+    /**
+     * @brief Images of the vectors of u by the matrix m.
+     * @details r must have the size of u, it can be u.
+     */
+    static void apply(const Matrix3 &m, const Vector3Batch &u, Vector3Batch &r);
+
+    // STATIC FACTORY METHODS
+
+    inline static Vector3Batch zeros(size_t size) { return Vector3Batch(size); }
+
+    inline static Vector3Batch ones(size_t size) { return scalar(1, size); }
+
+    static Vector3Batch scalar(double_t scalar, size_t size);
+
+protected:
+
+    std::vector<double_t> _x;
+
+    std::vector<double_t> _y;
+
+    std::vector<double_t> _z;
+};
+
+/** @} */
+
+#endif //MATHTOOLKIT_VECTOR3BATCH_H
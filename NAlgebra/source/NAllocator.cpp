@@ -0,0 +1,70 @@
+//
+// Created by bendou on 04/02/19.
+//
+
+#include <algorithm>
+#include <NAllocator.h>
+
+using namespace std;
+
+NArena::Scope::Scope() : _arena(NArena::local()), _block(_arena._block), _offset(_arena._offset) {
+    _arena._depth++;
+}
+
+NArena::Scope::~Scope() {
+    _arena._block = _block;
+    _arena._offset = _offset;
+    if (--_arena._depth == 0)
+        _arena.trim();
+}
+
+NArena::~NArena() {
+    NAllocator<char> allocator;
+
+    for (auto &block : _blocks) {
+        allocator.deallocate(block.first, block.second);
+    }
+}
+
+NArena &NArena::local() {
+    static thread_local NArena arena;
+    return arena;
+}
+
+size_t NArena::capacity() const {
+    size_t capacity = 0;
+
+    for (const auto &block : _blocks) {
+        capacity += block.second;
+    }
+    return capacity;
+}
+
+void *NArena::reserve(size_t bytes) {
+    bytes = (bytes + NALLOCATOR_ALIGNMENT - 1) / NALLOCATOR_ALIGNMENT * NALLOCATOR_ALIGNMENT;
+
+    // The blocks following the current one are free, the first one large enough is taken
+    while (_block < _blocks.size() && _offset + bytes > _blocks[_block].second) {
+        _block++;
+        _offset = 0;
+    }
+    if (_block == _blocks.size()) {
+        size_t size = max<size_t>(NARENA_BLOCK, bytes);
+        _blocks.emplace_back(NAllocator<char>().allocate(size), size);
+    }
+
+    void *p = _blocks[_block].first + _offset;
+    _offset += bytes;
+    return p;
+}
+
+void NArena::trim() {
+    NAllocator<char> allocator;
+    auto large = [](const pair<char *, size_t> &block) { return block.second > NARENA_BLOCK; };
+
+    for (auto &block : _blocks) {
+        if (large(block))
+            allocator.deallocate(block.first, block.second);
+    }
+    _blocks.erase(remove_if(_blocks.begin(), _blocks.end(), large), _blocks.end());
+}
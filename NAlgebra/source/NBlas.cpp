@@ -0,0 +1,983 @@
+//
+// Created by bendou on 29/01/19.
+//
+
+#include <NBlas.h>
+#include <NLanes.h>
+#include <NAllocator.h>
+#include <cstring>
+
+using namespace std;
+
+// Packed type of the blocks and number of columns of the micro-kernel, given the type of C. Integers are multiplied by
+// pairs of 16-bit integers, KR consecutive components of a row of A or of a column of B being packed together.
+
+template<typename C>
+struct NPacking;
+
+template<>
+struct NPacking<double_t> {
+    typedef double_t type;
+    static const size_t nr = NBLAS_NR, kr = 1;
+};
+
+template<>
+struct NPacking<float> {
+    typedef float type;
+    static const size_t nr = NBLAS_NR32, kr = 1;
+};
+
+template<>
+struct NPacking<int32_t> {
+    typedef int16_t type;
+    static const size_t nr = NBLAS_NR32, kr = 2;
+};
+
+template<typename TA, typename TB, typename C>
+void NBlas::gemmBlocked(size_t n, size_t p, size_t k, const TA *a, size_t rsa, size_t csa,
+                        const TB *b, size_t rsb, size_t csb, C *c, size_t ldc) {
+    typedef typename NPacking<C>::type P;
+    const size_t NR = NPacking<C>::nr, KR = NPacking<C>::kr;
+
+    // Packing doesn't pay for small matrices
+    if (n * p * k < NBLAS_GEMM_MIN) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t l = 0; l < k; ++l) {
+                C a_il = a[i * rsa + l * csa];
+                const TB *b_l = b + l * rsb;
+                if (csb == 1) {
+                    for (size_t j = 0; j < p; ++j) {
+                        c[i * ldc + j] += a_il * C(b_l[j]);
+                    }
+                } else {
+                    for (size_t j = 0; j < p; ++j) {
+                        c[i * ldc + j] += a_il * C(b_l[j * csb]);
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    // Blocks of rows of C are shared between the threads, each one packs its own blocks of A
+    size_t threads = n * p * k >= NBLAS_PARALLEL_MIN ? NPool::instance().size() : 1;
+    size_t mc = min<size_t>(NBLAS_MC, ((n + threads - 1) / threads + NBLAS_MR - 1) / NBLAS_MR * NBLAS_MR);
+    size_t blocks = (n + mc - 1) / mc;
+    NArena::Scope scratch;
+    P *pb = scratch.alloc<P>(NBLAS_KC * ((min<size_t>(p, NBLAS_NC) + NR - 1) / NR) * NR);
+
+    for (size_t jc = 0; jc < p; jc += NBLAS_NC) {
+        size_t nc = min<size_t>(NBLAS_NC, p - jc);
+        for (size_t pc = 0; pc < k; pc += NBLAS_KC) {
+            // Columns of the packed blocks are padded to a multiple of KR
+            size_t kc = min<size_t>(NBLAS_KC, k - pc), kcp = (kc + KR - 1) / KR * KR;
+            packB<TB, P, NR, KR>(kc, nc, b + pc * rsb + jc * csb, rsb, csb, pb);
+
+            auto block = [&](size_t r) {
+                NArena::Scope local;
+                P *pa = local.alloc<P>(NBLAS_MC * NBLAS_KC);
+                size_t ic = r * mc, mr = min<size_t>(mc, n - ic);
+
+                packA<TA, P, KR>(mr, kc, a + ic * rsa + pc * csa, rsa, csa, pa);
+                macroKernel<P, C, NR>(mr, nc, kcp, pa, pb, c + ic * ldc + jc, ldc);
+            };
+            if (threads > 1) {
+                NPool::instance().run(blocks, block);
+            } else {
+                for (size_t r = 0; r < blocks; ++r) {
+                    block(r);
+                }
+            }
+        }
+    }
+}
+
+void NBlas::gemm(size_t n, size_t p, size_t k, const double_t *a, size_t lda, const double_t *b, size_t ldb,
+                 double_t *c, size_t ldc) {
+    gemmBlocked(n, p, k, a, lda, 1, b, ldb, 1, c, ldc);
+}
+
+void NBlas::gemm(size_t n, size_t p, size_t k, const float *a, size_t lda, const float *b, size_t ldb,
+                 float *c, size_t ldc) {
+    gemmBlocked(n, p, k, a, lda, 1, b, ldb, 1, c, ldc);
+}
+
+void NBlas::gemm(size_t n, size_t p, size_t k, const double_t *a, size_t rsa, size_t csa,
+                 const double_t *b, size_t rsb, size_t csb, double_t *c, size_t ldc) {
+    gemmBlocked(n, p, k, a, rsa, csa, b, rsb, csb, c, ldc);
+}
+
+void NBlas::gemm(size_t n, size_t p, size_t k, const float *a, size_t rsa, size_t csa,
+                 const float *b, size_t rsb, size_t csb, float *c, size_t ldc) {
+    gemmBlocked(n, p, k, a, rsa, csa, b, rsb, csb, c, ldc);
+}
+
+void NBlas::gemm(size_t n, size_t p, size_t k, const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                 int32_t *c, size_t ldc) {
+    gemmBlocked(n, p, k, a, lda, 1, b, ldb, 1, c, ldc);
+}
+
+void NBlas::gemm(size_t n, size_t p, size_t k, const uint8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                 int32_t *c, size_t ldc) {
+    gemmBlocked(n, p, k, a, lda, 1, b, ldb, 1, c, ldc);
+}
+
+void NBlas::gemm(size_t n, size_t p, size_t k, const int8_t *a, size_t rsa, size_t csa,
+                 const int8_t *b, size_t rsb, size_t csb, int32_t *c, size_t ldc) {
+    gemmBlocked(n, p, k, a, rsa, csa, b, rsb, csb, c, ldc);
+}
+
+void NBlas::gemm(size_t n, size_t p, size_t k, const uint8_t *a, size_t rsa, size_t csa,
+                 const int8_t *b, size_t rsb, size_t csb, int32_t *c, size_t ldc) {
+    gemmBlocked(n, p, k, a, rsa, csa, b, rsb, csb, c, ldc);
+}
+
+// Widest lanes available for each precision and the scalar lane processing the remaining components
+
+template<typename T>
+struct NWide;
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+template<>
+struct NWide<double_t> {
+    typedef NLanes type;
+    typedef NLane lane;
+};
+
+template<>
+struct NWide<float> {
+    typedef NLanesF type;
+    typedef NLaneF lane;
+};
+
+#else
+
+template<>
+struct NWide<double_t> {
+    typedef NLane type;
+    typedef NLane lane;
+};
+
+template<>
+struct NWide<float> {
+    typedef NLaneF type;
+    typedef NLaneF lane;
+};
+
+#endif
+
+// Sum of n > 0 components added pairwise, halves being summed first
+template<typename T>
+static T pairwise(const T *x, size_t n) {
+    if (n == 1)
+        return x[0];
+    return pairwise(x, n / 2) + pairwise(x + n / 2, n - n / 2);
+}
+
+// Sum of the components of x, or of the products x_l y_l when y is not null. Four registers accumulate independent
+// sums, their lanes are added pairwise at the end.
+template<typename L>
+static typename L::scalar sumLanes(size_t n, const typename L::scalar *x, const typename L::scalar *y) {
+    typedef typename L::scalar S;
+    const size_t w = L::size;
+    typename L::type s0 = L::set(0), s1 = s0, s2 = s0, s3 = s0;
+    size_t l = 0;
+
+    if (y != nullptr) {
+        for (; l + 4 * w <= n; l += 4 * w) {
+            s0 = L::fmadd(L::load(x + l), L::load(y + l), s0);
+            s1 = L::fmadd(L::load(x + l + w), L::load(y + l + w), s1);
+            s2 = L::fmadd(L::load(x + l + 2 * w), L::load(y + l + 2 * w), s2);
+            s3 = L::fmadd(L::load(x + l + 3 * w), L::load(y + l + 3 * w), s3);
+        }
+        for (; l + w <= n; l += w) {
+            s0 = L::fmadd(L::load(x + l), L::load(y + l), s0);
+        }
+    } else {
+        for (; l + 4 * w <= n; l += 4 * w) {
+            s0 = L::add(L::load(x + l), s0);
+            s1 = L::add(L::load(x + l + w), s1);
+            s2 = L::add(L::load(x + l + 2 * w), s2);
+            s3 = L::add(L::load(x + l + 3 * w), s3);
+        }
+        for (; l + w <= n; l += w) {
+            s0 = L::add(L::load(x + l), s0);
+        }
+    }
+
+    S lanes[w], sum;
+    L::store(lanes, L::add(L::add(s0, s1), L::add(s2, s3)));
+    sum = pairwise(lanes, w);
+    for (; l < n; ++l) {
+        sum += y != nullptr ? x[l] * y[l] : x[l];
+    }
+    return sum;
+}
+
+// Indices of the first minimum and of the first maximum of n > 0 components of x, or of their absolute values. The
+// lanes keep the extremums of the components they load along with their indices, stored as scalars of the lanes.
+template<typename L, bool ABS>
+static void minmaxLanes(size_t n, const typename L::scalar *x, size_t &imin, size_t &imax) {
+    typedef typename L::scalar S;
+    const size_t w = L::size;
+    size_t l = 1;
+    S lo, hi;
+
+    imin = imax = 0;
+    lo = hi = ABS ? std::abs(x[0]) : x[0];
+    if (n >= w) {
+        S k[w], lov[w], hiv[w], ilov[w], ihiv[w];
+        for (size_t r = 0; r < w; ++r) {
+            k[r] = r;
+        }
+
+        typename L::type idx = L::load(k), step = L::set(w);
+        typename L::type vlo = ABS ? L::abs(L::load(x)) : L::load(x), vhi = vlo, ilo = idx, ihi = idx;
+        for (l = w; l + w <= n; l += w) {
+            typename L::type v = ABS ? L::abs(L::load(x + l)) : L::load(x + l);
+            idx = L::add(idx, step);
+
+            typename L::mask m = L::greater(vlo, v);
+            vlo = L::blend(vlo, v, m);
+            ilo = L::blend(ilo, idx, m);
+            m = L::greater(v, vhi);
+            vhi = L::blend(vhi, v, m);
+            ihi = L::blend(ihi, idx, m);
+        }
+        L::store(lov, vlo);
+        L::store(hiv, vhi);
+        L::store(ilov, ilo);
+        L::store(ihiv, ihi);
+
+        // Equal extremums of several lanes are resolved by their indices
+        lo = lov[0];
+        hi = hiv[0];
+        imin = (size_t) ilov[0];
+        imax = (size_t) ihiv[0];
+        for (size_t r = 1; r < w; ++r) {
+            if (lov[r] < lo || (lov[r] == lo && (size_t) ilov[r] < imin)) {
+                lo = lov[r];
+                imin = (size_t) ilov[r];
+            }
+            if (hiv[r] > hi || (hiv[r] == hi && (size_t) ihiv[r] < imax)) {
+                hi = hiv[r];
+                imax = (size_t) ihiv[r];
+            }
+        }
+    }
+    for (; l < n; ++l) {
+        S v = ABS ? std::abs(x[l]) : x[l];
+        if (v < lo) {
+            lo = v;
+            imin = l;
+        }
+        if (v > hi) {
+            hi = v;
+            imax = l;
+        }
+    }
+}
+
+// Adds s_0 x_0 + ... + s_{R-1} x_{R-1} to the components [l, l + L::size) of y
+template<typename L, size_t R>
+static inline void combineLanes(size_t l, const typename L::scalar *const *x, const typename L::scalar *s,
+                                typename L::scalar *y) {
+    typename L::type v = L::load(y + l);
+    for (size_t r = 0; r < R; ++r) {
+        v = L::fmadd(L::set(s[r]), L::load(x[r] + l), v);
+    }
+    L::store(y + l, v);
+}
+
+template<typename T, size_t R>
+static void combineRows(size_t n, const T *const *x, const T *s, T *y) {
+    typedef typename NWide<T>::type L;
+    size_t l = 0;
+
+    for (; l + L::size <= n; l += L::size) {
+        combineLanes<L, R>(l, x, s, y);
+    }
+    for (; l < n; ++l) {
+        combineLanes<typename NWide<T>::lane, R>(l, x, s, y);
+    }
+}
+
+template<typename T>
+void NBlas::gemvRows(size_t n, size_t p, const T *a, size_t lda, const T *x, T *y) {
+    auto rows = [&](size_t r) {
+        for (size_t i = r * NBLAS_GEMV_ROWS; i < min<size_t>(n, (r + 1) * NBLAS_GEMV_ROWS); ++i) {
+            y[i] += sumLanes<typename NWide<T>::type>(p, a + i * lda, x);
+        }
+    };
+    size_t tasks = (n + NBLAS_GEMV_ROWS - 1) / NBLAS_GEMV_ROWS;
+
+    if (n * p >= NBLAS_GEMV_PARALLEL_MIN) {
+        NPool::instance().run(tasks, rows);
+    } else {
+        for (size_t r = 0; r < tasks; ++r) {
+            rows(r);
+        }
+    }
+}
+
+void NBlas::gemv(size_t n, size_t p, const double_t *a, size_t lda, const double_t *x, double_t *y) {
+    gemvRows(n, p, a, lda, x, y);
+}
+
+void NBlas::gemv(size_t n, size_t p, const float *a, size_t lda, const float *x, float *y) {
+    gemvRows(n, p, a, lda, x, y);
+}
+
+// Solves the systems starting at a and b, their components being count apart
+template<typename L>
+static void gesvLanes(size_t n, size_t count, double_t *a, double_t *b) {
+    typedef typename L::type V;
+    auto a_ij = [=](size_t i, size_t j) { return a + (i * n + j) * count; };
+    auto b_i = [=](size_t i) { return b + i * count; };
+
+    for (size_t j = 0; j < n; ++j) {
+        // Each lane finds its own pivot, rows are swapped in the lanes where it was found
+        V best = L::abs(L::load(a_ij(j, j))), piv = L::set(j);
+        for (size_t i = j + 1; i < n; ++i) {
+            V x = L::abs(L::load(a_ij(i, j)));
+            typename L::mask m = L::greater(x, best);
+            best = L::blend(best, x, m);
+            piv = L::blend(piv, L::set(i), m);
+        }
+        for (size_t i = j + 1; i < n; ++i) {
+            typename L::mask m = L::equal(piv, L::set(i));
+            if (!L::any(m))
+                continue;
+            for (size_t k = j; k < n; ++k) {
+                V x = L::load(a_ij(j, k)), y = L::load(a_ij(i, k));
+                L::store(a_ij(j, k), L::blend(x, y, m));
+                L::store(a_ij(i, k), L::blend(y, x, m));
+            }
+            V x = L::load(b_i(j)), y = L::load(b_i(i));
+            L::store(b_i(j), L::blend(x, y, m));
+            L::store(b_i(i), L::blend(y, x, m));
+        }
+
+        V inv = L::div(L::set(1.0), L::load(a_ij(j, j))), b_j = L::load(b_i(j));
+        for (size_t i = j + 1; i < n; ++i) {
+            V l_ij = L::mul(L::load(a_ij(i, j)), inv);
+            L::store(a_ij(i, j), l_ij);
+            for (size_t k = j + 1; k < n; ++k) {
+                L::store(a_ij(i, k), L::fnmadd(l_ij, L::load(a_ij(j, k)), L::load(a_ij(i, k))));
+            }
+            L::store(b_i(i), L::fnmadd(l_ij, b_j, L::load(b_i(i))));
+        }
+    }
+
+    for (size_t i = n; i-- > 0;) {
+        V x = L::load(b_i(i));
+        for (size_t k = i + 1; k < n; ++k) {
+            x = L::fnmadd(L::load(a_ij(i, k)), L::load(b_i(k)), x);
+        }
+        L::store(b_i(i), L::div(x, L::load(a_ij(i, i))));
+    }
+}
+
+void NBlas::gesvBatch(size_t n, size_t count, double_t *a, double_t *b) {
+    auto systems = [&](size_t r) {
+        size_t s = r * NBLAS_GESV_BATCH, end = min<size_t>(count, s + NBLAS_GESV_BATCH);
+#if defined(__AVX2__) && defined(__FMA__)
+        for (; s + NLanes::size <= end; s += NLanes::size) {
+            gesvLanes<NLanes>(n, count, a + s, b + s);
+        }
+#endif
+        for (; s < end; ++s) {
+            gesvLanes<NLane>(n, count, a + s, b + s);
+        }
+    };
+    size_t tasks = (count + NBLAS_GESV_BATCH - 1) / NBLAS_GESV_BATCH;
+
+    if (count * n * n * n >= NBLAS_PARALLEL_MIN) {
+        NPool::instance().run(tasks, systems);
+    } else {
+        for (size_t r = 0; r < tasks; ++r) {
+            systems(r);
+        }
+    }
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+void NBlas::axpy(size_t n, double_t s, const double_t *x, double_t *y) {
+    const __m256d a = _mm256_set1_pd(s);
+    size_t k = 0;
+
+    for (; k + 4 <= n; k += 4) {
+        _mm256_storeu_pd(y + k, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + k), _mm256_loadu_pd(y + k)));
+    }
+    for (; k < n; ++k) {
+        y[k] += s * x[k];
+    }
+}
+
+void NBlas::axpy(size_t n, float s, const float *x, float *y) {
+    const __m256 a = _mm256_set1_ps(s);
+    size_t k = 0;
+
+    for (; k + 8 <= n; k += 8) {
+        _mm256_storeu_ps(y + k, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + k), _mm256_loadu_ps(y + k)));
+    }
+    for (; k < n; ++k) {
+        y[k] += s * x[k];
+    }
+}
+
+void NBlas::scal(size_t n, double_t s, double_t *x) {
+    const __m256d a = _mm256_set1_pd(s);
+    size_t k = 0;
+
+    for (; k + 4 <= n; k += 4) {
+        _mm256_storeu_pd(x + k, _mm256_mul_pd(a, _mm256_loadu_pd(x + k)));
+    }
+    for (; k < n; ++k) {
+        x[k] *= s;
+    }
+}
+
+void NBlas::scal(size_t n, float s, float *x) {
+    const __m256 a = _mm256_set1_ps(s);
+    size_t k = 0;
+
+    for (; k + 8 <= n; k += 8) {
+        _mm256_storeu_ps(x + k, _mm256_mul_ps(a, _mm256_loadu_ps(x + k)));
+    }
+    for (; k < n; ++k) {
+        x[k] *= s;
+    }
+}
+
+void NBlas::swap(size_t n, double_t *x, double_t *y) {
+    size_t k = 0;
+
+    for (; k + 4 <= n; k += 4) {
+        __m256d u = _mm256_loadu_pd(x + k), v = _mm256_loadu_pd(y + k);
+        _mm256_storeu_pd(x + k, v);
+        _mm256_storeu_pd(y + k, u);
+    }
+    std::swap_ranges(x + k, x + n, y + k);
+}
+
+void NBlas::swap(size_t n, float *x, float *y) {
+    size_t k = 0;
+
+    for (; k + 8 <= n; k += 8) {
+        __m256 u = _mm256_loadu_ps(x + k), v = _mm256_loadu_ps(y + k);
+        _mm256_storeu_ps(x + k, v);
+        _mm256_storeu_ps(y + k, u);
+    }
+    std::swap_ranges(x + k, x + n, y + k);
+}
+
+#else
+
+void NBlas::axpy(size_t n, double_t s, const double_t *x, double_t *y) {
+    for (size_t k = 0; k < n; ++k) {
+        y[k] += s * x[k];
+    }
+}
+
+void NBlas::axpy(size_t n, float s, const float *x, float *y) {
+    for (size_t k = 0; k < n; ++k) {
+        y[k] += s * x[k];
+    }
+}
+
+void NBlas::scal(size_t n, double_t s, double_t *x) {
+    for (size_t k = 0; k < n; ++k) {
+        x[k] *= s;
+    }
+}
+
+void NBlas::scal(size_t n, float s, float *x) {
+    for (size_t k = 0; k < n; ++k) {
+        x[k] *= s;
+    }
+}
+
+void NBlas::swap(size_t n, double_t *x, double_t *y) {
+    std::swap_ranges(x, x + n, y);
+}
+
+void NBlas::swap(size_t n, float *x, float *y) {
+    std::swap_ranges(x, x + n, y);
+}
+
+#endif
+
+template<typename T, typename R>
+void NBlas::combineBlocks(size_t n, size_t count, const R &rows, const T *s, T *y) {
+    auto block = [&](size_t b) {
+        size_t j = b * NBLAS_COMBINE_NB, nb = min<size_t>(NBLAS_COMBINE_NB, n - j), k = 0;
+        const T *x[4];
+
+        for (; k + 4 <= count; k += 4) {
+            for (size_t r = 0; r < 4; ++r) {
+                x[r] = rows(k + r) + j;
+            }
+            combineRows<T, 4>(nb, x, s + k, y + j);
+        }
+        for (; k < count; ++k) {
+            x[0] = rows(k) + j;
+            combineRows<T, 1>(nb, x, s + k, y + j);
+        }
+    };
+    size_t blocks = (n + NBLAS_COMBINE_NB - 1) / NBLAS_COMBINE_NB;
+
+    if (n * count >= NBLAS_GEMV_PARALLEL_MIN) {
+        NPool::instance().run(blocks, block);
+    } else {
+        for (size_t b = 0; b < blocks; ++b) {
+            block(b);
+        }
+    }
+}
+
+void NBlas::gemvT(size_t n, size_t p, const double_t *a, size_t lda, const double_t *x, double_t *y) {
+    combineBlocks(p, n, [a, lda](size_t i) { return a + i * lda; }, x, y);
+}
+
+void NBlas::gemvT(size_t n, size_t p, const float *a, size_t lda, const float *x, float *y) {
+    combineBlocks(p, n, [a, lda](size_t i) { return a + i * lda; }, x, y);
+}
+
+void NBlas::combine(size_t n, size_t count, const double_t *const *x, const double_t *s, double_t *y) {
+    combineBlocks(n, count, [x](size_t k) { return x[k]; }, s, y);
+}
+
+void NBlas::combine(size_t n, size_t count, const float *const *x, const float *s, float *y) {
+    combineBlocks(n, count, [x](size_t k) { return x[k]; }, s, y);
+}
+
+template<typename T>
+T NBlas::sumBlocks(size_t n, const T *x, const T *y) {
+    size_t blocks = (n + NBLAS_REDUCE_NB - 1) / NBLAS_REDUCE_NB;
+
+    if (blocks <= 1)
+        return sumLanes<typename NWide<T>::type>(n, x, y);
+
+    vector<T> sums(blocks);
+    auto block = [&](size_t b) {
+        size_t l = b * NBLAS_REDUCE_NB;
+        sums[b] = sumLanes<typename NWide<T>::type>(min<size_t>(NBLAS_REDUCE_NB, n - l), x + l,
+                                                    y != nullptr ? y + l : nullptr);
+    };
+
+    if (n >= NBLAS_REDUCE_PARALLEL_MIN) {
+        NPool::instance().run(blocks, block);
+    } else {
+        for (size_t b = 0; b < blocks; ++b) {
+            block(b);
+        }
+    }
+    return pairwise(sums.data(), blocks);
+}
+
+template<typename T, bool ABS>
+void NBlas::minmaxBlocks(size_t n, const T *x, size_t &imin, size_t &imax) {
+    size_t blocks = (n + NBLAS_REDUCE_NB - 1) / NBLAS_REDUCE_NB;
+
+    assert(n > 0);
+    if (blocks <= 1) {
+        minmaxLanes<typename NWide<T>::type, ABS>(n, x, imin, imax);
+        return;
+    }
+
+    vector<size_t> imins(blocks), imaxs(blocks);
+    auto block = [&](size_t b) {
+        size_t l = b * NBLAS_REDUCE_NB;
+        minmaxLanes<typename NWide<T>::type, ABS>(min<size_t>(NBLAS_REDUCE_NB, n - l), x + l, imins[b], imaxs[b]);
+        imins[b] += l;
+        imaxs[b] += l;
+    };
+
+    if (n >= NBLAS_REDUCE_PARALLEL_MIN) {
+        NPool::instance().run(blocks, block);
+    } else {
+        for (size_t b = 0; b < blocks; ++b) {
+            block(b);
+        }
+    }
+
+    // Blocks are merged in order so that the first extremums are kept
+    imin = imins[0];
+    imax = imaxs[0];
+    for (size_t b = 1; b < blocks; ++b) {
+        if ((ABS ? std::abs(x[imins[b]]) < std::abs(x[imin]) : x[imins[b]] < x[imin]))
+            imin = imins[b];
+        if ((ABS ? std::abs(x[imaxs[b]]) > std::abs(x[imax]) : x[imaxs[b]] > x[imax]))
+            imax = imaxs[b];
+    }
+}
+
+double_t NBlas::sum(size_t n, const double_t *x) {
+    return sumBlocks<double_t>(n, x, nullptr);
+}
+
+float NBlas::sum(size_t n, const float *x) {
+    return sumBlocks<float>(n, x, nullptr);
+}
+
+double_t NBlas::dot(size_t n, const double_t *x, const double_t *y) {
+    return sumBlocks(n, x, y);
+}
+
+float NBlas::dot(size_t n, const float *x, const float *y) {
+    return sumBlocks(n, x, y);
+}
+
+void NBlas::minmax(size_t n, const double_t *x, size_t &imin, size_t &imax) {
+    minmaxBlocks<double_t, false>(n, x, imin, imax);
+}
+
+void NBlas::minmax(size_t n, const float *x, size_t &imin, size_t &imax) {
+    minmaxBlocks<float, false>(n, x, imin, imax);
+}
+
+void NBlas::minmaxAbs(size_t n, const double_t *x, size_t &imin, size_t &imax) {
+    minmaxBlocks<double_t, true>(n, x, imin, imax);
+}
+
+void NBlas::minmaxAbs(size_t n, const float *x, size_t &imin, size_t &imax) {
+    minmaxBlocks<float, true>(n, x, imin, imax);
+}
+
+// Squares of B x B components transposed in registers, the others one by one
+
+template<typename T>
+struct NTransposeKernel {
+    static const size_t size = 1;
+
+    static inline void square(const T *a, size_t, T *b, size_t) { *b = *a; }
+};
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+template<>
+struct NTransposeKernel<double_t> {
+    static const size_t size = 4;
+
+    static inline void square(const double_t *a, size_t lda, double_t *b, size_t ldb) {
+        __m256d r0 = _mm256_loadu_pd(a), r1 = _mm256_loadu_pd(a + lda),
+                r2 = _mm256_loadu_pd(a + 2 * lda), r3 = _mm256_loadu_pd(a + 3 * lda);
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1),
+                t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+
+        _mm256_storeu_pd(b, _mm256_permute2f128_pd(t0, t2, 0x20));
+        _mm256_storeu_pd(b + ldb, _mm256_permute2f128_pd(t1, t3, 0x20));
+        _mm256_storeu_pd(b + 2 * ldb, _mm256_permute2f128_pd(t0, t2, 0x31));
+        _mm256_storeu_pd(b + 3 * ldb, _mm256_permute2f128_pd(t1, t3, 0x31));
+    }
+};
+
+template<>
+struct NTransposeKernel<float> {
+    static const size_t size = 8;
+
+    static inline void square(const float *a, size_t lda, float *b, size_t ldb) {
+        __m256 r[8], t[8], u[8];
+
+        for (size_t i = 0; i < 8; ++i) {
+            r[i] = _mm256_loadu_ps(a + i * lda);
+        }
+        // Pairs, then quadruples of rows are interleaved, the halves of the registers are exchanged last
+        for (size_t i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+        for (size_t i = 0; i < 8; i += 4) {
+            u[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            u[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            u[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            u[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+        for (size_t i = 0; i < 4; ++i) {
+            _mm256_storeu_ps(b + i * ldb, _mm256_permute2f128_ps(u[i], u[i + 4], 0x20));
+            _mm256_storeu_ps(b + (i + 4) * ldb, _mm256_permute2f128_ps(u[i], u[i + 4], 0x31));
+        }
+    }
+};
+
+#endif
+
+template<typename T>
+static void transposeBlock(size_t n, size_t p, const T *a, size_t lda, T *b, size_t ldb) {
+    typedef NTransposeKernel<T> K;
+
+    if (n > NBLAS_TRANSPOSE_NB || p > NBLAS_TRANSPOSE_NB) {
+        // Halves are rounded to squares of the kernel so that the edges are only met at the end
+        if (n >= p) {
+            size_t h = (n / 2 + K::size - 1) / K::size * K::size;
+            transposeBlock(h, p, a, lda, b, ldb);
+            transposeBlock(n - h, p, a + h * lda, lda, b + h, ldb);
+        } else {
+            size_t h = (p / 2 + K::size - 1) / K::size * K::size;
+            transposeBlock(n, h, a, lda, b, ldb);
+            transposeBlock(n, p - h, a + h, lda, b + h * ldb, ldb);
+        }
+        return;
+    }
+
+    size_t n0 = n / K::size * K::size, p0 = p / K::size * K::size;
+    for (size_t i = 0; i < n0; i += K::size) {
+        for (size_t j = 0; j < p0; j += K::size) {
+            K::square(a + i * lda + j, lda, b + j * ldb + i, ldb);
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i < n0 ? p0 : 0; j < p; ++j) {
+            b[j * ldb + i] = a[i * lda + j];
+        }
+    }
+}
+
+void NBlas::transpose(size_t n, size_t p, const double_t *a, size_t lda, double_t *b, size_t ldb) {
+    transposeBlock(n, p, a, lda, b, ldb);
+}
+
+void NBlas::transpose(size_t n, size_t p, const float *a, size_t lda, float *b, size_t ldb) {
+    transposeBlock(n, p, a, lda, b, ldb);
+}
+
+void NBlas::quantize(size_t n, const float *x, float scale, int8_t *q) {
+    const float inv = 1.0f / scale;
+
+    for (size_t k = 0; k < n; ++k) {
+        q[k] = (int8_t) max(-127.0f, min(127.0f, nearbyint(x[k] * inv)));
+    }
+}
+
+void NBlas::dequantize(size_t n, const int32_t *x, float scale, float *y) {
+    for (size_t k = 0; k < n; ++k) {
+        y[k] = scale * (float) x[k];
+    }
+}
+
+template<typename TA, typename P, size_t KR>
+void NBlas::packA(size_t mc, size_t kc, const TA *a, size_t rs, size_t cs, P *pa) {
+    // Panels of NBLAS_MR rows stored by groups of KR columns, the last panel and group are padded with zeros
+    for (size_t i = 0; i < mc; i += NBLAS_MR) {
+        size_t mr = min<size_t>(NBLAS_MR, mc - i);
+        for (size_t l = 0; l < kc; l += KR) {
+            for (size_t r = 0; r < NBLAS_MR; ++r) {
+                for (size_t q = 0; q < KR; ++q) {
+                    *pa++ = r < mr && l + q < kc ? P(a[(i + r) * rs + (l + q) * cs]) : P(0);
+                }
+            }
+        }
+    }
+}
+
+template<typename TB, typename P, size_t NR, size_t KR>
+void NBlas::packB(size_t kc, size_t nc, const TB *b, size_t rs, size_t cs, P *pb) {
+    // Panels of NR columns stored by groups of KR rows, the last panel and group are padded with zeros
+    for (size_t j = 0; j < nc; j += NR) {
+        size_t nr = min<size_t>(NR, nc - j);
+        for (size_t l = 0; l < kc; l += KR) {
+            for (size_t r = 0; r < NR; ++r) {
+                for (size_t q = 0; q < KR; ++q) {
+                    *pb++ = r < nr && l + q < kc ? P(b[(l + q) * rs + (j + r) * cs]) : P(0);
+                }
+            }
+        }
+    }
+}
+
+template<typename P, typename C, size_t NR>
+void NBlas::macroKernel(size_t mc, size_t nc, size_t kc, const P *pa, const P *pb, C *c, size_t ldc) {
+    C edge[NBLAS_MR * NR];
+
+    for (size_t j = 0; j < nc; j += NR) {
+        size_t nr = min<size_t>(NR, nc - j);
+        for (size_t i = 0; i < mc; i += NBLAS_MR) {
+            size_t mr = min<size_t>(NBLAS_MR, mc - i);
+            const P *pa_i = pa + i * kc, *pb_j = pb + j * kc;
+            C *c_ij = c + i * ldc + j;
+
+            if (mr == NBLAS_MR && nr == NR) {
+                microKernel(kc, pa_i, pb_j, c_ij, ldc);
+                continue;
+            }
+
+            // Blocks on the edges of C are computed aside
+            fill(edge, edge + NBLAS_MR * NR, C(0));
+            microKernel(kc, pa_i, pb_j, edge, NR);
+            for (size_t r = 0; r < mr; ++r) {
+                for (size_t s = 0; s < nr; ++s) {
+                    c_ij[r * ldc + s] += edge[r * NR + s];
+                }
+            }
+        }
+    }
+}
+
+// Micro-kernel written for any packed type, used when the instructions of the optimized ones are not available
+template<typename P, typename C, size_t NR, size_t KR>
+static void microKernelRef(size_t kc, const P *pa, const P *pb, C *c, size_t ldc) {
+    C acc[NBLAS_MR][NR] = {};
+
+    for (size_t l = 0; l < kc; l += KR, pa += NBLAS_MR * KR, pb += NR * KR) {
+        for (size_t r = 0; r < NBLAS_MR; ++r) {
+            for (size_t s = 0; s < NR; ++s) {
+                for (size_t q = 0; q < KR; ++q) {
+                    acc[r][s] += C(pa[r * KR + q]) * C(pb[s * KR + q]);
+                }
+            }
+        }
+    }
+
+    for (size_t r = 0; r < NBLAS_MR; ++r) {
+        for (size_t s = 0; s < NR; ++s) {
+            c[r * ldc + s] += acc[r][s];
+        }
+    }
+}
+
+#if defined(__AVX2__) && defined(__FMA__) && NBLAS_MR == 6 && NBLAS_NR == 8 && NBLAS_NR32 == 16
+
+void NBlas::microKernel(size_t kc, const double_t *pa, const double_t *pb, double_t *c, size_t ldc) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd(), c10 = _mm256_setzero_pd(),
+            c11 = _mm256_setzero_pd(), c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd(),
+            c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd(), c40 = _mm256_setzero_pd(),
+            c41 = _mm256_setzero_pd(), c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+    __m256d b0, b1, a;
+
+    // 12 accumulators, 2 rows of B and a broadcast element of A fill 15 of the 16 registers
+    for (size_t l = 0; l < kc; ++l, pa += NBLAS_MR, pb += NBLAS_NR) {
+        b0 = _mm256_loadu_pd(pb);
+        b1 = _mm256_loadu_pd(pb + 4);
+
+        a = _mm256_broadcast_sd(pa);
+        c00 = _mm256_fmadd_pd(a, b0, c00);
+        c01 = _mm256_fmadd_pd(a, b1, c01);
+        a = _mm256_broadcast_sd(pa + 1);
+        c10 = _mm256_fmadd_pd(a, b0, c10);
+        c11 = _mm256_fmadd_pd(a, b1, c11);
+        a = _mm256_broadcast_sd(pa + 2);
+        c20 = _mm256_fmadd_pd(a, b0, c20);
+        c21 = _mm256_fmadd_pd(a, b1, c21);
+        a = _mm256_broadcast_sd(pa + 3);
+        c30 = _mm256_fmadd_pd(a, b0, c30);
+        c31 = _mm256_fmadd_pd(a, b1, c31);
+        a = _mm256_broadcast_sd(pa + 4);
+        c40 = _mm256_fmadd_pd(a, b0, c40);
+        c41 = _mm256_fmadd_pd(a, b1, c41);
+        a = _mm256_broadcast_sd(pa + 5);
+        c50 = _mm256_fmadd_pd(a, b0, c50);
+        c51 = _mm256_fmadd_pd(a, b1, c51);
+    }
+
+    const __m256d acc[NBLAS_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t r = 0; r < NBLAS_MR; ++r, c += ldc) {
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), acc[r][0]));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), acc[r][1]));
+    }
+}
+
+void NBlas::microKernel(size_t kc, const float *pa, const float *pb, float *c, size_t ldc) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps(), c10 = _mm256_setzero_ps(),
+           c11 = _mm256_setzero_ps(), c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps(),
+           c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps(), c40 = _mm256_setzero_ps(),
+           c41 = _mm256_setzero_ps(), c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+    __m256 b0, b1, a;
+
+    // Same blocking as in double precision, each register holding 8 components of C
+    for (size_t l = 0; l < kc; ++l, pa += NBLAS_MR, pb += NBLAS_NR32) {
+        b0 = _mm256_loadu_ps(pb);
+        b1 = _mm256_loadu_ps(pb + 8);
+
+        a = _mm256_broadcast_ss(pa);
+        c00 = _mm256_fmadd_ps(a, b0, c00);
+        c01 = _mm256_fmadd_ps(a, b1, c01);
+        a = _mm256_broadcast_ss(pa + 1);
+        c10 = _mm256_fmadd_ps(a, b0, c10);
+        c11 = _mm256_fmadd_ps(a, b1, c11);
+        a = _mm256_broadcast_ss(pa + 2);
+        c20 = _mm256_fmadd_ps(a, b0, c20);
+        c21 = _mm256_fmadd_ps(a, b1, c21);
+        a = _mm256_broadcast_ss(pa + 3);
+        c30 = _mm256_fmadd_ps(a, b0, c30);
+        c31 = _mm256_fmadd_ps(a, b1, c31);
+        a = _mm256_broadcast_ss(pa + 4);
+        c40 = _mm256_fmadd_ps(a, b0, c40);
+        c41 = _mm256_fmadd_ps(a, b1, c41);
+        a = _mm256_broadcast_ss(pa + 5);
+        c50 = _mm256_fmadd_ps(a, b0, c50);
+        c51 = _mm256_fmadd_ps(a, b1, c51);
+    }
+
+    const __m256 acc[NBLAS_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t r = 0; r < NBLAS_MR; ++r, c += ldc) {
+        _mm256_storeu_ps(c, _mm256_add_ps(_mm256_loadu_ps(c), acc[r][0]));
+        _mm256_storeu_ps(c + 8, _mm256_add_ps(_mm256_loadu_ps(c + 8), acc[r][1]));
+    }
+}
+
+// Broadcast of the pair of 16-bit integers of A starting at pa
+static inline __m256i broadcastPair(const int16_t *pa) {
+    int32_t pair;
+
+    memcpy(&pair, pa, sizeof(pair));
+    return _mm256_set1_epi32(pair);
+}
+
+void NBlas::microKernel(size_t kc, const int16_t *pa, const int16_t *pb, int32_t *c, size_t ldc) {
+    __m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256(), c10 = _mm256_setzero_si256(),
+            c11 = _mm256_setzero_si256(), c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256(),
+            c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256(), c40 = _mm256_setzero_si256(),
+            c41 = _mm256_setzero_si256(), c50 = _mm256_setzero_si256(), c51 = _mm256_setzero_si256();
+    __m256i b0, b1, a;
+
+    // A pair of rows of B and a broadcast pair of A are multiplied and summed in the 32-bit lanes by madd
+    for (size_t l = 0; l < kc; l += 2, pa += 2 * NBLAS_MR, pb += 2 * NBLAS_NR32) {
+        b0 = _mm256_loadu_si256((const __m256i *) pb);
+        b1 = _mm256_loadu_si256((const __m256i *) (pb + 16));
+
+        a = broadcastPair(pa);
+        c00 = _mm256_add_epi32(c00, _mm256_madd_epi16(a, b0));
+        c01 = _mm256_add_epi32(c01, _mm256_madd_epi16(a, b1));
+        a = broadcastPair(pa + 2);
+        c10 = _mm256_add_epi32(c10, _mm256_madd_epi16(a, b0));
+        c11 = _mm256_add_epi32(c11, _mm256_madd_epi16(a, b1));
+        a = broadcastPair(pa + 4);
+        c20 = _mm256_add_epi32(c20, _mm256_madd_epi16(a, b0));
+        c21 = _mm256_add_epi32(c21, _mm256_madd_epi16(a, b1));
+        a = broadcastPair(pa + 6);
+        c30 = _mm256_add_epi32(c30, _mm256_madd_epi16(a, b0));
+        c31 = _mm256_add_epi32(c31, _mm256_madd_epi16(a, b1));
+        a = broadcastPair(pa + 8);
+        c40 = _mm256_add_epi32(c40, _mm256_madd_epi16(a, b0));
+        c41 = _mm256_add_epi32(c41, _mm256_madd_epi16(a, b1));
+        a = broadcastPair(pa + 10);
+        c50 = _mm256_add_epi32(c50, _mm256_madd_epi16(a, b0));
+        c51 = _mm256_add_epi32(c51, _mm256_madd_epi16(a, b1));
+    }
+
+    const __m256i acc[NBLAS_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t r = 0; r < NBLAS_MR; ++r, c += ldc) {
+        __m256i *c0 = (__m256i *) c, *c1 = (__m256i *) (c + 8);
+        _mm256_storeu_si256(c0, _mm256_add_epi32(_mm256_loadu_si256(c0), acc[r][0]));
+        _mm256_storeu_si256(c1, _mm256_add_epi32(_mm256_loadu_si256(c1), acc[r][1]));
+    }
+}
+
+#else
+
+void NBlas::microKernel(size_t kc, const double_t *pa, const double_t *pb, double_t *c, size_t ldc) {
+    microKernelRef<double_t, double_t, NBLAS_NR, 1>(kc, pa, pb, c, ldc);
+}
+
+void NBlas::microKernel(size_t kc, const float *pa, const float *pb, float *c, size_t ldc) {
+    microKernelRef<float, float, NBLAS_NR32, 1>(kc, pa, pb, c, ldc);
+}
+
+void NBlas::microKernel(size_t kc, const int16_t *pa, const int16_t *pb, int32_t *c, size_t ldc) {
+    microKernelRef<int16_t, int32_t, NBLAS_NR32, 2>(kc, pa, pb, c, ldc);
+}
+
+#endif
@@ -3,6 +3,7 @@
 //
 
 #include <NPMatrix.h>
+#include <NBlas.h>
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wabsolute-value"
@@ -77,18 +78,13 @@ bool NPMatrix<T>::isDiagonal() const {
 template<typename T>
 NVector<T> NPMatrix<T>::row(size_t i) const {
     assert(isValidRowIndex(i));
-    return vector<T>{this->begin() + _p * i, this->begin() + _p * (i + 1)};
+    return NStorage<T>(this->begin() + _p * i, this->begin() + _p * (i + 1));
 }
 
 template<typename T>
 NVector<T> NPMatrix<T>::col(size_t j) const {
     assert(isValidColIndex(j));
-
-    vector<T> data(_n);
-    for (size_t k = 0; k < _n; ++k) {
-        data[k] = (*this)(k, j);
-    }
-    return NVector<T>(data);
+    return view().col(j);
 }
 
 template<typename T>
@@ -179,7 +175,6 @@ NPMatrix<T> NPMatrix<T>::lupU() const {
     return u;
 }
 
-
 // ROWS/COLS/SUB SETTERS
 
 
@@ -228,20 +223,172 @@ NPMatrix<T> &NPMatrix<T>::setCols(const vector<NVector<T>> &vectors, size_t j1)
 
 // MANIPULATORS
 
+// ROW OPERATIONS
+
+// Row operation y = y + s x on n contiguous components
+template<typename T>
+static void rowAxpy(size_t n, T s, const T *x, T *y) {
+    for (size_t k = 0; k < n; ++k) {
+        y[k] += s * x[k];
+    }
+}
+
+static void rowAxpy(size_t n, double_t s, const double_t *x, double_t *y) {
+    NBlas::axpy(n, s, x, y);
+}
+
+static void rowAxpy(size_t n, float s, const float *x, float *y) {
+    NBlas::axpy(n, s, x, y);
+}
+
+// Row operation x = x / s, integer rows are divided component by component
+template<typename T>
+static void rowDiv(size_t n, T s, T *x) {
+    for (size_t k = 0; k < n; ++k) {
+        x[k] /= s;
+    }
+}
+
+static void rowDiv(size_t n, double_t s, double_t *x) {
+    NBlas::scal(n, 1 / s, x);
+}
+
+static void rowDiv(size_t n, float s, float *x) {
+    NBlas::scal(n, 1 / s, x);
+}
+
+template<typename T>
+static void rowSwap(size_t n, T *x, T *y) {
+    std::swap_ranges(x, x + n, y);
+}
+
+static void rowSwap(size_t n, double_t *x, double_t *y) {
+    NBlas::swap(n, x, y);
+}
+
+static void rowSwap(size_t n, float *x, float *y) {
+    NBlas::swap(n, x, y);
+}
+
+// Opposite of x for the types without unary minus
+template<typename T>
+static inline T negated(T x) {
+    T y = 0;
+    y -= x;
+    return y;
+}
+
 // TRANSPOSED
+
+// Transposition b = a^T of a n x p sub-array, the largest dimension being split in halves until blocks fit in cache
 template<typename T>
-NPMatrix<T> NPMatrix<T>::transposed() const {
-    NPMatrix<T> temp{_j2 - _j1 + 1, _i2 - _i1 + 1};
+static void transposeBlock(size_t n, size_t p, const T *a, size_t lda, T *b, size_t ldb) {
+    if (n > NBLAS_TRANSPOSE_NB || p > NBLAS_TRANSPOSE_NB) {
+        if (n >= p) {
+            transposeBlock(n / 2, p, a, lda, b, ldb);
+            transposeBlock(n - n / 2, p, a + n / 2 * lda, lda, b + n / 2, ldb);
+        } else {
+            transposeBlock(n, p / 2, a, lda, b, ldb);
+            transposeBlock(n, p - p / 2, a + p / 2, lda, b + p / 2 * ldb, ldb);
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < p; ++j) {
+            b[j * ldb + i] = a[i * lda + j];
+        }
+    }
+}
+
+static void transposeBlock(size_t n, size_t p, const double_t *a, size_t lda, double_t *b, size_t ldb) {
+    NBlas::transpose(n, p, a, lda, b, ldb);
+}
+
+static void transposeBlock(size_t n, size_t p, const float *a, size_t lda, float *b, size_t ldb) {
+    NBlas::transpose(n, p, a, lda, b, ldb);
+}
 
-    for (auto i = _i1; i <= _i2; ++i) {
-        for (auto j = _j1; j <= _j2; ++j) {
-            temp(j - _j1, i - _i1) = (*this)(i, j);
+// Exchange of a n x p block x with the transposed of the p x n block y, both split the same way as in transpose
+template<typename T>
+static void swapTransposed(size_t n, size_t p, T *x, T *y, size_t ld) {
+    if (n > NBLAS_TRANSPOSE_NB || p > NBLAS_TRANSPOSE_NB) {
+        if (n >= p) {
+            swapTransposed(n / 2, p, x, y, ld);
+            swapTransposed(n - n / 2, p, x + n / 2 * ld, y + n / 2, ld);
+        } else {
+            swapTransposed(n, p / 2, x, y, ld);
+            swapTransposed(n, p - p / 2, x + p / 2, y + p / 2 * ld, ld);
         }
+        return;
     }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < p; ++j) {
+            std::swap(x[i * ld + j], y[j * ld + i]);
+        }
+    }
+}
+
+// In place transposition of a n x n sub-array, the blocks on both sides of the diagonal are exchanged
+template<typename T>
+static void transposeSquare(size_t n, T *a, size_t ld) {
+    if (n > NBLAS_TRANSPOSE_NB) {
+        size_t h = n / 2;
+        transposeSquare(h, a, ld);
+        transposeSquare(n - h, a + h * ld + h, ld);
+        swapTransposed(h, n - h, a + h, a + h * ld, ld);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            std::swap(a[i * ld + j], a[j * ld + i]);
+        }
+    }
+}
+
+// In place transposition of a n x p array. The component k = i p + j moves to j n + i = k n mod (n p - 1), the
+// cycles of this permutation are followed once, visited components being marked
+template<typename T>
+static void transposeCycles(size_t n, size_t p, T *a) {
+    const size_t size = n * p;
+    vector<bool> visited(size);
+
+    for (size_t start = 1; start + 1 < size; ++start) {
+        if (visited[start])
+            continue;
+        T x = a[start];
+        size_t k = start;
+        do {
+            k = k * n % (size - 1);
+            std::swap(x, a[k]);
+            visited[k] = true;
+        } while (k != start);
+    }
+}
+
+template<typename T>
+NPMatrix<T> NPMatrix<T>::transposed() const {
+    NPMatrix<T> temp{_j2 - _j1 + 1, _i2 - _i1 + 1};
+
+    transposeBlock(temp._p, temp._n, this->data() + vectorIndex(_i1, _j1), _p, temp.data(), temp._p);
     setDefaultBrowseIndices();
     return temp;
 }
 
+template<typename T>
+NPMatrix<T> &NPMatrix<T>::transpose() {
+    size_t n = _i2 - _i1 + 1, p = _j2 - _j1 + 1;
+
+    if (n == p) {
+        transposeSquare(n, this->data() + vectorIndex(_i1, _j1), _p);
+        return clean();
+    }
+
+    assert(n == _n && p == _p);
+    transposeCycles(_n, _p, this->data());
+    std::swap(_n, _p);
+    return clean();
+}
+
 template<typename T>
 T NPMatrix<T>::trace() const {
     T trace = 0;
@@ -273,19 +420,25 @@ NPMatrix<T> NPMatrix<T>::shifted(const NPMatrix<T> &m) const {
 
 template<typename T>
 NPMatrix<T> &NPMatrix<T>::reduce() {
+    T *a = this->data();
     size_t r = 0, k, i, j;
-    NVector<T> spin;
-    for (j = 0; j < floor(_p / 2); ++j) {
 
-        k = maxAbsIndexCol(j, r);
-        if (abs((*this)(k, j)) > EPSILON) {
-            setRow(row(k) / (*this)(k, j), k);
-            swapRow(k, r);
+    // Rows are combined in place, the pivot row is used directly in the storage
+    for (j = 0; j < _p / 2 && r < _n; ++j) {
+        k = r;
+        for (i = r + 1; i < _n; ++i) {
+            if (abs(a[i * _p + j]) > abs(a[k * _p + j]))
+                k = i;
+        }
+        if (abs(a[k * _p + j]) > EPSILON) {
+            rowDiv(_p, a[k * _p + j], a + k * _p);
+            if (k != r)
+                rowSwap(_p, a + k * _p, a + r * _p);
 
-            spin = row(r);
+            const T *a_r = a + r * _p;
             for (i = 0; i < _n; ++i) {
                 if (i != r)
-                    setRow(row(i) - (*this)(i, j) * spin, i);
+                    rowAxpy(_p, negated(a[i * _p + j]), a_r, a + i * _p);
             }
             r++;
         }
@@ -303,7 +456,7 @@ T NPMatrix<T>::det() const {
         for (size_t i = 1; i < _a->_n; i++) {
             det *= (*_a)(i, i);
         }
-        det = (((*_perm)[_a->_n - 1] - (_a->_n - 1)) % 2 == 0) ? det : -det;
+        det = (((*_perm)[_a->_n] - _a->_n) % 2 == 0) ? det : -det;
 
         if (_a->_n != _n) {
             lupClear();
@@ -397,15 +550,67 @@ NPMatrix<T>::NPMatrix(const NVector<T> &u, size_t n, size_t p, size_t i1, size_t
     setDefaultBrowseIndices();
 }
 
+template<typename T>
+NPMatrix<T>::NPMatrix(const NMatrixView<T> &m) : NPMatrix(m.n(), m.p()) {
+    if (m.layout() == RowMajor) {
+        for (size_t i = 0; i < _n; ++i) {
+            std::copy(m.data() + i * m.ld(), m.data() + i * m.ld() + _p, this->begin() + vectorIndex(i, 0));
+        }
+        return;
+    }
+
+    // The columns of m are the rows of a row-major p x n array
+    transposeBlock(_p, _n, m.data(), m.ld(), this->data(), _p);
+}
+
+template<typename T>
+NPMatrix<T>::NPMatrix(NVector<T> &&u, size_t n, size_t p) :
+        NVector<T>(std::move(u)),
+        _n(n), _p(p),
+        _i1(0), _j1(0), _i2(0), _j2(0),
+        _a(nullptr), _perm(nullptr) {
+    setDefaultBrowseIndices();
+}
+
+template<typename T>
+NStorage<T> NPMatrix<T>::release() {
+    bool whole = hasDefaultBrowseIndices();
+    size_t n = whole ? _n : _i2 - _i1 + 1, p = whole ? _p : _j2 - _j1 + 1;
+
+    // Each component of the sub-matrix is moved to a lower index, rows can be packed in place
+    if (!whole) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < p; ++j) {
+                (*this)[i * p + j] = std::move((*this)[vectorIndex(i + _i1, j + _j1)]);
+            }
+        }
+    }
+    NVector<T>::setDefaultBrowseIndices();
+    NStorage<T> data = NVector<T>::release();
+
+    data.erase(data.begin() + n * p, data.end());
+    _n = 0;
+    _p = 0;
+    lupClear();
+    setDefaultBrowseIndices();
+    return data;
+}
+
 // MANIPULATORS
 
 template<typename T>
 NPMatrix<T> &NPMatrix<T>::swap(const Parts element, size_t k1, size_t k2) {
+    if (element == Row) {
+        assert(isValidRowIndex(k1) && isValidRowIndex(k2));
+        if (k1 != k2)
+            rowSwap(_p, this->data() + _p * k1, this->data() + _p * k2);
+        return clean();
+    }
 
-    NVector<T> temp = (element == Row) ? NPMatrix<T>::row(k1) : col(k1);
+    NVector<T> temp = col(k1);
 
-    (element == Row) ? setRow(row(k2), k1) : setCol(col(k2), k1);
-    (element == Row) ? setRow(temp, k2) : setCol(temp, k2);
+    setCol(col(k2), k1);
+    setCol(temp, k2);
 
     return clean();
 }
@@ -436,16 +641,396 @@ size_t NPMatrix<T>::maxAbsIndex(const Parts element, size_t k, size_t r) const {
 
 // ALGEBRAICAL OPERATIONS
 
+// Product c = c + a b of n x k and k x p row-major sub-arrays, accumulated in the order of the dot product
 template<typename T>
-NVector<T> &NPMatrix<T>::vectorProduct(NVector<T> &u) const {
+static void gemm(size_t n, size_t p, size_t k, const T *a, size_t lda, const T *b, size_t ldb, T *c, size_t ldc) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t l = 0; l < k; ++l) {
+            const T a_il = a[i * lda + l];
+            for (size_t j = 0; j < p; ++j) {
+                c[i * ldc + j] += a_il * b[l * ldb + j];
+            }
+        }
+    }
+}
 
-    NVector<T> res = NVector<T>::zeros(u.dim());
+static void gemm(size_t n, size_t p, size_t k, const double_t *a, size_t lda, const double_t *b, size_t ldb,
+                 double_t *c, size_t ldc) {
+    NBlas::gemm(n, p, k, a, lda, b, ldb, c, ldc);
+}
 
-    assert(matchSizeForProduct(res));
+static void gemm(size_t n, size_t p, size_t k, const float *a, size_t lda, const float *b, size_t ldb,
+                 float *c, size_t ldc) {
+    NBlas::gemm(n, p, k, a, lda, b, ldb, c, ldc);
+}
 
-    for (size_t i = _i1; i <= _i2; ++i) {
-        res(i - _i1) = row(i)(_j1, _j2) | u;
+// Product c = c + a b of sub-arrays of any layout, the component (i, j) of a being at a[i * rsa + j * csa]
+template<typename T>
+static void gemm(size_t n, size_t p, size_t k, const T *a, size_t rsa, size_t csa, const T *b, size_t rsb, size_t csb,
+                 T *c, size_t ldc) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t l = 0; l < k; ++l) {
+            const T a_il = a[i * rsa + l * csa];
+            for (size_t j = 0; j < p; ++j) {
+                c[i * ldc + j] += a_il * b[l * rsb + j * csb];
+            }
+        }
+    }
+}
+
+static void gemm(size_t n, size_t p, size_t k, const double_t *a, size_t rsa, size_t csa,
+                 const double_t *b, size_t rsb, size_t csb, double_t *c, size_t ldc) {
+    NBlas::gemm(n, p, k, a, rsa, csa, b, rsb, csb, c, ldc);
+}
+
+static void gemm(size_t n, size_t p, size_t k, const float *a, size_t rsa, size_t csa,
+                 const float *b, size_t rsb, size_t csb, float *c, size_t ldc) {
+    NBlas::gemm(n, p, k, a, rsa, csa, b, rsb, csb, c, ldc);
+}
+
+// Product y = y + a x of a n x p row-major sub-array and a vector
+template<typename T>
+static void gemv(size_t n, size_t p, const T *a, size_t lda, const T *x, T *y) {
+    for (size_t i = 0; i < n; ++i) {
+        T dot = 0;
+        for (size_t l = 0; l < p; ++l) {
+            dot += x[l] * a[i * lda + l];
+        }
+        y[i] += dot;
+    }
+}
+
+static void gemv(size_t n, size_t p, const double_t *a, size_t lda, const double_t *x, double_t *y) {
+    NBlas::gemv(n, p, a, lda, x, y);
+}
+
+static void gemv(size_t n, size_t p, const float *a, size_t lda, const float *x, float *y) {
+    NBlas::gemv(n, p, a, lda, x, y);
+}
+
+// Product y = y + a^T x of a n x p sub-array, combination of the rows of a
+template<typename T>
+static void gemvT(size_t n, size_t p, const T *a, size_t lda, const T *x, T *y) {
+    for (size_t i = 0; i < n; ++i) {
+        const T *a_i = a + i * lda, x_i = x[i];
+        for (size_t j = 0; j < p; ++j) {
+            y[j] += x_i * a_i[j];
+        }
+    }
+}
+
+static void gemvT(size_t n, size_t p, const double_t *a, size_t lda, const double_t *x, double_t *y) {
+    NBlas::gemvT(n, p, a, lda, x, y);
+}
+
+static void gemvT(size_t n, size_t p, const float *a, size_t lda, const float *x, float *y) {
+    NBlas::gemvT(n, p, a, lda, x, y);
+}
+
+// Product c = c - a b, computed by adding the product of -a
+template<typename T>
+static void gemmSub(size_t n, size_t p, size_t k, const T *a, size_t lda, const T *b, size_t ldb, T *c, size_t ldc) {
+    NArena::Scope scratch;
+    T *opp = scratch.alloc<T>(n * k);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t l = 0; l < k; ++l) {
+            T x = 0;
+            x -= a[i * lda + l];
+            opp[i * k + l] = x;
+        }
+    }
+    gemm(n, p, k, opp, k, b, ldb, c, ldc);
+}
+
+// Solves L X = B in place, L is the n x n unit lower triangle of l and B is n x p
+template<typename T>
+static void solveLower(size_t n, size_t p, const T *l, size_t ldl, T *b, size_t ldb) {
+    if (n > NPMATRIX_LUP_MIN) {
+        size_t h = n / 2;
+        solveLower(h, p, l, ldl, b, ldb);
+        gemmSub(n - h, p, h, l + h * ldl, ldl, b, ldb, b + h * ldb, ldb);
+        solveLower(n - h, p, l + h * ldl + h, ldl, b + h * ldb, ldb);
+        return;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        T *b_i = b + i * ldb;
+        for (size_t k = 0; k < i; ++k) {
+            rowAxpy(p, negated(l[i * ldl + k]), b + k * ldb, b_i);
+        }
+    }
+}
+
+// Solves U X = B in place, U is the n x n upper triangle of u and B is n x p
+template<typename T>
+static void solveUpper(size_t n, size_t p, const T *u, size_t ldu, T *b, size_t ldb) {
+    if (n > NPMATRIX_LUP_MIN) {
+        size_t h = n / 2;
+        solveUpper(n - h, p, u + h * ldu + h, ldu, b + h * ldb, ldb);
+        gemmSub(h, p, n - h, u + h, ldu, b + h * ldb, ldb, b, ldb);
+        solveUpper(h, p, u, ldu, b, ldb);
+        return;
+    }
+    for (size_t i = n; i-- > 0;) {
+        T *b_i = b + i * ldb;
+        for (size_t k = i + 1; k < n; ++k) {
+            rowAxpy(p, negated(u[i * ldu + k]), b + k * ldb, b_i);
+        }
+        rowDiv(p, u[i * ldu + i], b_i);
+    }
+}
+
+// Factorizes the columns [c1, c2) of the rows [c1, n) of a, the left columns being already factorized.
+// The panel is split in two halves recursively so that most of the work is done by matrix products.
+template<typename T>
+static bool lupPanel(T *a, size_t n, size_t c1, size_t c2, vector<size_t> &perm) {
+    if (c2 - c1 > NPMATRIX_LUP_MIN) {
+        size_t c = c1 + (c2 - c1) / 2;
+        if (!lupPanel(a, n, c1, c, perm))
+            return false;
+        solveLower(c - c1, c2 - c, a + c1 * n + c1, n, a + c1 * n + c, n);
+        gemmSub(n - c, c2 - c, c - c1, a + c * n + c1, n, a + c1 * n + c, n, a + c * n + c, n);
+        return lupPanel(a, n, c, c2, perm);
     }
+
+    for (size_t j = c1; j < c2; ++j) {
+        size_t i_max = j;
+        for (size_t i = j + 1; i < n; ++i) {
+            if (abs(a[i * n + j]) > abs(a[i_max * n + j]))
+                i_max = i;
+        }
+        if (abs(a[i_max * n + j]) <= EPSILON) //matrix is degenerate
+            return false;
+
+        // Rows are swapped on their whole length
+        if (i_max != j) {
+            std::swap(perm[j], perm[i_max]);
+            rowSwap(n, a + j * n, a + i_max * n);
+            perm[n]++; //counting pivots starting from n (for determinant)
+        }
+
+        const T *a_j = a + j * n;
+        for (size_t i = j + 1; i < n; ++i) {
+            T *a_i = a + i * n;
+            a_i[j] /= a_j[j];
+            rowAxpy(c2 - j - 1, negated(a_i[j]), a_j + j + 1, a_i + j + 1);
+        }
+    }
+    return true;
+}
+
+// Product c = c - a^T b, a being k x n
+template<typename T>
+static void gemmSubT(size_t n, size_t p, size_t k, const T *a, size_t lda, const T *b, size_t ldb, T *c, size_t ldc) {
+    NArena::Scope scratch;
+    T *opp = scratch.alloc<T>(n * k);
+    for (size_t l = 0; l < k; ++l) {
+        for (size_t i = 0; i < n; ++i) {
+            T x = 0;
+            x -= a[l * lda + i];
+            opp[i * k + l] = x;
+        }
+    }
+    gemm(n, p, k, opp, k, b, ldb, c, ldc);
+}
+
+// Upper triangle of c = c - a^T a, a being k x n. Diagonal blocks are updated on their whole
+template<typename T>
+static void syrkSub(size_t n, size_t k, const T *a, size_t lda, T *c, size_t ldc) {
+    if (n > NPMATRIX_LUP_MIN) {
+        size_t h = n / 2;
+        syrkSub(h, k, a, lda, c, ldc);
+        gemmSubT(h, n - h, k, a, lda, a + h, lda, c + h, ldc);
+        syrkSub(n - h, k, a + h, lda, c + h * ldc + h, ldc);
+        return;
+    }
+    gemmSubT(n, n, k, a, lda, a, lda, c, ldc);
+}
+
+// Solves U^T X = B in place, U is the n x n upper triangle of u and B is n x p
+template<typename T>
+static void solveUpperT(size_t n, size_t p, const T *u, size_t ldu, T *b, size_t ldb) {
+    if (n > NPMATRIX_LUP_MIN) {
+        size_t h = n / 2;
+        solveUpperT(h, p, u, ldu, b, ldb);
+        gemmSubT(n - h, p, h, u + h, ldu, b, ldb, b + h * ldb, ldb);
+        solveUpperT(n - h, p, u + h * ldu + h, ldu, b + h * ldb, ldb);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        T *b_i = b + i * ldb;
+        for (size_t k = 0; k < i; ++k) {
+            const T u_ki = u[k * ldu + i], *b_k = b + k * ldb;
+            for (size_t j = 0; j < p; ++j) {
+                b_i[j] -= u_ki * b_k[j];
+            }
+        }
+        const T u_ii = u[i * ldu + i];
+        for (size_t j = 0; j < p; ++j) {
+            b_i[j] /= u_ii;
+        }
+    }
+}
+
+// Factorizes the n x n matrix a = U^T U in place, only its upper triangle is read and written
+template<typename T>
+static bool cholFactor(size_t n, T *a, size_t lda) {
+    if (n > NPMATRIX_LUP_MIN) {
+        size_t h = n / 2;
+        if (!cholFactor(h, a, lda))
+            return false;
+        solveUpperT(h, n - h, a, lda, a + h, lda);
+        syrkSub(n - h, h, a + h, lda, a + h * lda + h, lda);
+        return cholFactor(n - h, a + h * lda + h, lda);
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+        T *a_k = a + k * lda;
+        if (a_k[k] <= EPSILON) //matrix isn't positive-definite
+            return false;
+
+        a_k[k] = sqrt(a_k[k]);
+        for (size_t j = k + 1; j < n; ++j) {
+            a_k[j] /= a_k[k];
+        }
+        for (size_t i = k + 1; i < n; ++i) {
+            T *a_i = a + i * lda;
+            const T u_ki = a_k[i];
+            for (size_t j = i; j < n; ++j) {
+                a_i[j] -= u_ki * a_k[j];
+            }
+        }
+    }
+    return true;
+}
+
+// Applies the reflector I - tau v v^T of the column j of the n x p decomposition qr to the columns [c1, c2) of the
+// rows [j, n) of c
+template<typename T>
+static void qrReflect(size_t n, size_t p, const T *qr, size_t j, T tau, T *c, size_t ldc, size_t c1, size_t c2) {
+    NArena::Scope scratch;
+    T *w = scratch.alloc<T>(c2 - c1);
+
+    std::copy(c + j * ldc + c1, c + j * ldc + c2, w);
+
+    for (size_t i = j + 1; i < n; ++i) {
+        const T v_i = qr[i * p + j], *c_i = c + i * ldc + c1;
+        for (size_t k = 0; k < c2 - c1; ++k) {
+            w[k] += v_i * c_i[k];
+        }
+    }
+    T *c_j = c + j * ldc + c1;
+    for (size_t k = 0; k < c2 - c1; ++k) {
+        w[k] *= tau;
+        c_j[k] -= w[k];
+    }
+    for (size_t i = j + 1; i < n; ++i) {
+        T *c_i = c + i * ldc + c1;
+        const T v_i = qr[i * p + j];
+        for (size_t k = 0; k < c2 - c1; ++k) {
+            c_i[k] -= v_i * w[k];
+        }
+    }
+}
+
+// Householder reflectors of the columns [c1, c2) of the rows [c1, n) of a, applied to the columns of the panel only
+template<typename T>
+static bool qrPanel(size_t n, size_t p, T *a, size_t c1, size_t c2, vector<T> &tau) {
+    for (size_t j = c1; j < c2; ++j) {
+        T alpha = a[j * p + j], norm = alpha * alpha, total = 0;
+        for (size_t i = j + 1; i < n; ++i) {
+            norm += a[i * p + j] * a[i * p + j];
+        }
+        // Reflections keep the norm of the columns, the part above the diagonal gives the norm of the original column
+        for (size_t i = 0; i < j; ++i) {
+            total += a[i * p + j] * a[i * p + j];
+        }
+        total = sqrt(total + norm);
+        norm = sqrt(norm);
+        if (norm <= total * EPSILON * T((int) n)) //columns are linearly dependent
+            return false;
+
+        // The reflector sends the column to beta e_j, beta having the opposite sign of alpha to avoid cancellation
+        T beta = norm;
+        if (alpha > 0)
+            beta = -norm;
+        T scale = 1;
+        scale /= alpha - beta;
+        for (size_t i = j + 1; i < n; ++i) {
+            a[i * p + j] *= scale;
+        }
+        tau[j] = (beta - alpha) / beta;
+        a[j * p + j] = beta;
+
+        qrReflect(n, p, a, j, tau[j], a, p, j + 1, c2);
+    }
+    return true;
+}
+
+// Applies the reflectors of the columns [c1, c2) to the columns [c2, p) at once, Q^T C = C - V T^T V^T C
+template<typename T>
+static void qrUpdateTrailing(size_t n, size_t p, T *a, size_t c1, size_t c2, const vector<T> &tau) {
+    size_t m = n - c1, nb = c2 - c1, q = p - c2;
+    NArena::Scope scratch;
+    T *v = scratch.alloc<T>(m * nb), *vt = scratch.alloc<T>(nb * m), *tri = scratch.alloc<T>(nb * nb);
+    T *w = scratch.alloc<T>(nb * q), *z = scratch.alloc<T>(nb);
+
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < nb; ++j) {
+            T v_ij = 0;
+            if (i == j)
+                v_ij = 1;
+            else if (i > j)
+                v_ij = a[(c1 + i) * p + c1 + j];
+            v[i * nb + j] = v_ij;
+            vt[j * m + i] = v_ij;
+        }
+    }
+
+    // Upper triangular T such as H_0 ... H_(nb - 1) = I - V T V^T
+    for (size_t j = 0; j < nb; ++j) {
+        std::fill(z, z + j, T(0));
+        for (size_t r = 0; r < m; ++r) {
+            for (size_t i = 0; i < j; ++i) {
+                z[i] += vt[i * m + r] * vt[j * m + r];
+            }
+        }
+        for (size_t i = 0; i < j; ++i) {
+            T x = 0;
+            for (size_t l = i; l < j; ++l) {
+                x += tri[i * nb + l] * z[l];
+            }
+            T t_ij = 0;
+            t_ij -= tau[c1 + j] * x;
+            tri[i * nb + j] = t_ij;
+        }
+        tri[j * nb + j] = tau[c1 + j];
+    }
+
+    T *c = a + c1 * p + c2;
+    gemm(nb, q, m, vt, m, c, p, w, q);
+    for (size_t i = nb; i-- > 0;) {
+        T *w_i = w + i * q;
+        for (size_t k = 0; k < q; ++k) {
+            w_i[k] *= tri[i * nb + i];
+        }
+        for (size_t l = 0; l < i; ++l) {
+            const T t_li = tri[l * nb + i], *w_l = w + l * q;
+            for (size_t k = 0; k < q; ++k) {
+                w_i[k] += t_li * w_l[k];
+            }
+        }
+    }
+    gemmSub(m, q, nb, v, nb, w, q, c, p);
+}
+
+template<typename T>
+NVector<T> &NPMatrix<T>::vectorProduct(NVector<T> &u) const {
+
+    NVector<T> res = NVector<T>::zeros(_i2 - _i1 + 1);
+
+    assert(matchSizeForProduct(u));
+
+    gemv(_i2 - _i1 + 1, _j2 - _j1 + 1, this->data() + vectorIndex(_i1, _j1), _p, u.data(), res.data());
     u = res;
 
     setDefaultBrowseIndices();
@@ -457,20 +1042,69 @@ NPMatrix<T> &NPMatrix<T>::matrixProduct(const NPMatrix<T> &m) {
     assert(matchSizeForProduct(m));
     assert((_j2 - _j1 == _i2 - _i1) || hasDefaultBrowseIndices());
 
-    NPMatrix<T> res = NPMatrix<T>::zeros(_i2 - _i1 + 1, m._j2 - m._j1 + 1);
+    if (m._j2 - m._j1 == _j2 - _j1)
+        return matrixProduct(m.data() + m.vectorIndex(m._i1, m._j1), m._p);
 
+    NPMatrix<T> res = NPMatrix<T>::zeros(_i2 - _i1 + 1, m._j2 - m._j1 + 1);
 
-    for (size_t i = _i1; i <= _i2; ++i) {
-        for (size_t j = m._j1; j <= m._j2; ++j) {
-            res(i - _i1, j - m._j1) = row(i)(_j1, _j2) | m.col(j)(m._i1, m._i2);
-        }
-    }
+    gemm(res._n, res._p, _j2 - _j1 + 1, this->data() + vectorIndex(_i1, _j1), _p,
+         m.data() + m.vectorIndex(m._i1, m._j1), m._p, res.data(), res._p);
 
     copy(res);
     lupClear();
     return *this;
 }
 
+template<typename T>
+NPMatrix<T> &NPMatrix<T>::matrixProduct(const T *b, size_t ldb) {
+    size_t n = _i2 - _i1 + 1, p = _j2 - _j1 + 1;
+    NArena::Scope scratch;
+    T *c = scratch.alloc<T>(n * p);
+
+    // The result has the shape of the browsed sub-matrix, it is computed in scratch memory and copied back
+    gemm(n, p, p, this->data() + vectorIndex(_i1, _j1), _p, b, ldb, c, p);
+    for (size_t i = 0; i < n; ++i) {
+        std::copy(c + i * p, c + (i + 1) * p, this->data() + vectorIndex(_i1 + i, _j1));
+    }
+    return clean();
+}
+
+template<typename T>
+NPMatrix<T> NPMatrix<T>::product(const NMatrixView<T> &a, const NMatrixView<T> &b) {
+    assert(a.p() == b.n());
+
+    NPMatrix<T> res = NPMatrix<T>::zeros(a.n(), b.p());
+    if (a.layout() == RowMajor && b.layout() == RowMajor) {
+        gemm(a.n(), b.p(), a.p(), a.data(), a.ld(), b.data(), b.ld(), res.data(), res._p);
+    } else {
+        gemm(a.n(), b.p(), a.p(), a.data(), a.rowStride(), a.colStride(), b.data(), b.rowStride(), b.colStride(),
+             res.data(), res._p);
+    }
+    return res;
+}
+
+template<typename T>
+NVector<T> NPMatrix<T>::product(const NMatrixView<T> &a, const NVectorView<T> &x) {
+    assert(a.p() == x.dim());
+
+    NVector<T> res = NVector<T>::zeros(a.n());
+    if (a.layout() == ColMajor) {
+        // Linear combination of the contiguous columns, the transposed product of the row-major storage
+        if (x.stride() == 1) {
+            gemvT(a.p(), a.n(), a.data(), a.ld(), x.data(), res.data());
+        } else {
+            const NVector<T> u = x;
+            gemvT(a.p(), a.n(), a.data(), a.ld(), u.data(), res.data());
+        }
+    } else if (x.stride() == 1) {
+        gemv(a.n(), a.p(), a.data(), a.ld(), x.data(), res.data());
+    } else {
+        const NVector<T> u = x;
+        gemv(a.n(), a.p(), a.data(), a.ld(), u.data(), res.data());
+    }
+    return res;
+}
+
 template<typename T>
 NPMatrix<T> &NPMatrix<T>::pow(long exp) {
     if (exp > 0) {
@@ -487,42 +1121,38 @@ NPMatrix<T> &NPMatrix<T>::pow(long exp) {
 template<typename T>
 void NPMatrix<T>::rPow(const long exp) {
     if (exp > 1) {
-        const NPMatrix<T> this_copy{subMatrix(_i1, _j1, _i2, _j2)};
-        matrixProduct(this_copy);
+        size_t n = _i2 - _i1 + 1;
+        NArena::Scope scratch;
+        T *base = scratch.alloc<T>(n * n);
+
+        for (size_t i = 0; i < n; ++i) {
+            std::copy(this->data() + vectorIndex(_i1 + i, _j1), this->data() + vectorIndex(_i1 + i, _j2) + 1,
+                      base + i * n);
+        }
+        matrixProduct(base, n);
         if (exp % 2 == 0) {
             rPow(exp / 2);
         } else if (exp % 2 == 1) {
             rPow((exp - 1) / 2);
-            matrixProduct(this_copy);
+            matrixProduct(base, n);
         }
     }
 }
 
 template<typename T>
 NPMatrix<T> &NPMatrix<T>::inv() {
-    size_t i, j, k, l;
-
     if (_a == nullptr) { lupUpdate(); }
 
     if (_a != nullptr) {
-        for (j = 0; j < _a->_n; j++) {
-            for (i = 0; i < _a->_n; i++) {
-                (*this)(i + _i1, j + _j1) = (((*_perm)[i] == j) ? 1 : 0);
-                for (l = 0; l < i; ++l) {
-                    (*this)(i + _i1, j + _j1) -= (*_a)(i, l) * (*this)(l, j);
-                }
-            }
-            for (i = 0; i < _a->_n; i++) {
-                k = _a->_n - 1 - i;
-                for (l = k + 1; l < _a->_n; l++) {
-                    (*this)(k + _i1, j + _j1) -= (*_a)(k, l) * (*this)(l, j);
-                }
-                (*this)(k + _i1, j + _j1) /= (*_a)(k, k);
-            }
-        }
-        if (_a->_n != _n) {
-            lupClear();
+        size_t n = _a->_n;
+        NPMatrix<T> inverse = NPMatrix<T>::eye(n);
+
+        solve(inverse);
+        for (size_t i = 0; i < n; ++i) {
+            std::copy(inverse.data() + i * n, inverse.data() + (i + 1) * n,
+                      this->data() + vectorIndex(i + _i1, _j1));
         }
+        lupClear();
     }
     return *this;
 }
@@ -534,19 +1164,27 @@ NVector<T> &NPMatrix<T>::solve(NVector<T> &u) const {
     if (_a == nullptr) { lupUpdate(); }
 
     if (_i2 - _i1 + 1 == u.dim() && _a != nullptr) {
-        for (i = 0; i < _a->_n; i++) {
-            u(i) = u((*_perm)[i]);
+        size_t n = _a->_n;
+        const T *a = _a->data();
+        NArena::Scope scratch;
+        T *x = scratch.alloc<T>(n);
+
+        // Solving L U x = P u, the permutation is applied out of place
+        for (i = 0; i < n; i++) {
+            x[i] = u[(*_perm)[i]];
             for (l = 0; l < i; ++l) {
-                u(i) -= (*_a)(i, l) * u(l);
+                x[i] -= a[i * n + l] * x[l];
             }
         }
-        for (i = 0; i < _a->_n; i++) {
-            k = _a->_n - 1 - i;
-            for (l = k + 1; l < _a->_n; ++l) {
-                u(k) -= (*_a)(k, l) * u(l);
+        for (i = 0; i < n; i++) {
+            k = n - 1 - i;
+            for (l = k + 1; l < n; ++l) {
+                x[k] -= a[k * n + l] * x[l];
             }
-            u(k) /= (*_a)(k, k);
+            x[k] /= a[k * n + k];
         }
+        std::copy(x, x + n, u.begin());
+
         if (_a->_n != _n) {
             lupClear();
         }
@@ -555,20 +1193,170 @@ NVector<T> &NPMatrix<T>::solve(NVector<T> &u) const {
 }
 
 
+template<typename T>
+NPMatrix<T> &NPMatrix<T>::solve(NPMatrix<T> &b) const {
+    if (_a == nullptr) { lupUpdate(); }
+
+    if (_i2 - _i1 == b._i2 - b._i1 && _a != nullptr) {
+        size_t n = _a->_n, p = b._j2 - b._j1 + 1;
+        const T *a = _a->data();
+        T *b_1 = b.data() + b.vectorIndex(b._i1, b._j1);
+        NArena::Scope scratch;
+        T *x = scratch.alloc<T>(n * p);
+
+        // Solving L U X = P B on all the columns at once, the permutation is applied out of place
+        for (size_t i = 0; i < n; ++i) {
+            const T *b_i = b_1 + (*_perm)[i] * b._p;
+            std::copy(b_i, b_i + p, x + i * p);
+        }
+        solveLower(n, p, a, n, x, p);
+        solveUpper(n, p, a, n, x, p);
+        for (size_t i = 0; i < n; ++i) {
+            std::copy(x + i * p, x + (i + 1) * p, b_1 + i * b._p);
+        }
+        b.lupClear();
+
+        if (_a->_n != _n) {
+            lupClear();
+        }
+    }
+    return b;
+}
+
+template<typename T>
+NVector<T> &NPMatrix<T>::cholSolve(NVector<T> &u) const {
+    if (_chol == nullptr) { cholUpdate(); }
+
+    if (_i2 - _i1 + 1 == u.dim() && _chol != nullptr) {
+        size_t n = _chol->_n;
+
+        // Solving U^T U x = u
+        solveUpperT(n, 1, _chol->data(), n, u.data(), 1);
+        solveUpper(n, 1, _chol->data(), n, u.data(), 1);
+
+        if (_chol->_n != _n) {
+            lupClear();
+        }
+    }
+    return u;
+}
+
+template<typename T>
+NPMatrix<T> &NPMatrix<T>::cholSolve(NPMatrix<T> &b) const {
+    if (_chol == nullptr) { cholUpdate(); }
+
+    if (_i2 - _i1 == b._i2 - b._i1 && _chol != nullptr) {
+        size_t n = _chol->_n, p = b._j2 - b._j1 + 1;
+        T *b_1 = b.data() + b.vectorIndex(b._i1, b._j1);
+
+        solveUpperT(n, p, _chol->data(), n, b_1, b._p);
+        solveUpper(n, p, _chol->data(), n, b_1, b._p);
+        b.lupClear();
+
+        if (_chol->_n != _n) {
+            lupClear();
+        }
+    }
+    return b;
+}
+
+template<typename T>
+NVector<T> &NPMatrix<T>::qrSolve(NVector<T> &u) const {
+    if (_qr == nullptr) { qrUpdate(); }
+
+    if (_i2 - _i1 + 1 == u.dim() && _qr != nullptr) {
+        size_t n = _qr->_n, p = _qr->_p;
+        vector<T> y(u.begin(), u.begin() + n);
+
+        // Solving R x = Q^T u, the last n - p components of Q^T u are the residual
+        for (size_t j = 0; j < p; ++j) {
+            qrReflect(n, p, _qr->data(), j, (*_tau)[j], y.data(), 1, 0, 1);
+        }
+        solveUpper(p, 1, _qr->data(), p, y.data(), 1);
+        y.resize(p);
+        u = NVector<T>(std::move(y));
+
+        if (_qr->_n != _n || _qr->_p != _p) {
+            lupClear();
+        }
+    }
+    return u;
+}
+
+template<typename T>
+NPMatrix<T> NPMatrix<T>::cholL() const {
+    if (_chol == nullptr) { cholUpdate(); }
+
+    assert(_chol != nullptr);
+
+    NPMatrix<T> l = _chol->transposed();
+
+    if (_chol->_n != _n) {
+        lupClear();
+        setDefaultBrowseIndices();
+    }
+    return l;
+}
+
+template<typename T>
+NPMatrix<T> NPMatrix<T>::qrQ() const {
+    if (_qr == nullptr) { qrUpdate(); }
+
+    assert(_qr != nullptr);
+
+    size_t n = _qr->_n, p = _qr->_p;
+    NPMatrix<T> q = NPMatrix<T>::zeros(n, p);
+    for (size_t j = 0; j < p; ++j) {
+        q(j, j) = 1;
+    }
+    // Q = H_0 H_1 ... H_(p - 1) applied to the first columns of the identity, starting from the last reflector
+    for (size_t j = p; j-- > 0;) {
+        qrReflect(n, p, _qr->data(), j, (*_tau)[j], q.data(), p, j, p);
+    }
+
+    if (_qr->_n != _n || _qr->_p != _p) {
+        lupClear();
+        setDefaultBrowseIndices();
+    }
+    return q;
+}
+
+template<typename T>
+NPMatrix<T> NPMatrix<T>::qrR() const {
+    if (_qr == nullptr) { qrUpdate(); }
+
+    assert(_qr != nullptr);
+
+    size_t p = _qr->_p;
+    NPMatrix<T> r = NPMatrix<T>::zeros(p, p);
+    for (size_t i = 0; i < p; ++i) {
+        std::copy(_qr->data() + i * p + i, _qr->data() + (i + 1) * p, r.data() + i * p + i);
+    }
+
+    if (_qr->_n != _n || _qr->_p != _p) {
+        lupClear();
+        setDefaultBrowseIndices();
+    }
+    return r;
+}
+
 // LUP MANAGEMENT
 
 
+// Clears the Cholesky and QR decompositions too, all of them are invalidated when the components change
 template<typename T>
 void NPMatrix<T>::lupClear() const  {
     if(_a != nullptr){
         _a.reset(nullptr);
         _perm.reset(nullptr);
     }
+    _chol.reset(nullptr);
+    _qr.reset(nullptr);
+    _tau.reset(nullptr);
 }
 
 template<typename T>
 void NPMatrix<T>::lupReset() const {
-    lupClear();
     _a.reset(new NPMatrix<T>(subMatrix(_i1, _j1, _i2, _j2)));
     _perm.reset(new vector<size_t>(_a->_n + 1, 0));
     for (size_t i = 0; i <= _a->_n; ++i)
@@ -577,44 +1365,84 @@ void NPMatrix<T>::lupReset() const {
 
 template<typename T>
 void NPMatrix<T>::lupCopy(const NPMatrix &m) const {
+    if (this == &m)
+        return;
+
+    lupClear();
     if(m._a > nullptr) {
         _a.reset(new NPMatrix<T>(*(m._a)));
         _perm.reset(new vector<size_t>(m._perm->begin(), m._perm->end()));
-    } else {
-        lupClear();
     }
-
+    if (m._chol != nullptr) {
+        _chol.reset(new NPMatrix<T>(*(m._chol)));
+    }
+    if (m._qr != nullptr) {
+        _qr.reset(new NPMatrix<T>(*(m._qr)));
+        _tau.reset(new vector<T>(*(m._tau)));
+    }
 }
 
 template<typename T>
 void NPMatrix<T>::lupUpdate() const {
     //Returns PA such as PA = LU where P is a row p array and A = L * U;
-    size_t i, j, k, i_max;
-
     lupReset();
-    if (!_a->isUpper() || !_a->isLower()) {
-        for (i = 0; i < _a->_n; ++i) {
-            i_max = _a->col(i)(i, _a->_n - 1).maxAbsIndex() + i;
-            if (abs((*_a)(i_max, i)) > EPSILON) { //matrix is not degenerate
-                if (i_max != i) {
-                    j = (*_perm)[i];
-                    (*_perm)[i] = (*_perm)[i_max];
-                    (*_perm)[i_max] = j;
-
-                    _a->swapRow(i, i_max);
-
-                    (*_perm)[_a->_n]++; //counting pivots starting from a->_n (for determinant)
-                }
-            } else {
-                lupClear();
-                return;
-            }
-            for (j = i + 1; j < _a->_n; ++j) {
-                (*_a)(j, i) /= (*_a)(i, i);
-                for (k = i + 1; k < _a->_n; ++k) {
-                    (*_a)(j, k) -= (*_a)(j, i) * (*_a)(i, k);
-                }
-            }
+
+    size_t n = _a->_n;
+    T *a = _a->data();
+
+    // Right-looking blocked decomposition, the trailing matrix is updated with a matrix product after each panel
+    for (size_t k1 = 0; k1 < n; k1 += NPMATRIX_LUP_NB) {
+        size_t k2 = min<size_t>(k1 + NPMATRIX_LUP_NB, n);
+
+        if (!lupPanel(a, n, k1, k2, *_perm)) {
+            _a.reset(nullptr);
+            _perm.reset(nullptr);
+            return;
+        }
+        if (k2 < n) {
+            solveLower(k2 - k1, n - k2, a + k1 * n + k1, n, a + k1 * n + k2, n);
+            gemmSub(n - k2, n - k2, k2 - k1, a + k2 * n + k1, n, a + k1 * n + k2, n, a + k2 * n + k2, n);
+        }
+    }
+}
+
+
+template<typename T>
+void NPMatrix<T>::cholUpdate() const {
+    _chol.reset(new NPMatrix<T>(subMatrix(_i1, _j1, _i2, _j2)));
+
+    size_t n = _chol->_n;
+    T *u = _chol->data();
+
+    if (n != _chol->_p || !cholFactor(n, u, n)) {
+        _chol.reset(nullptr);
+        return;
+    }
+    // The lower triangle still holds the components of the matrix
+    for (size_t i = 1; i < n; ++i) {
+        std::fill(u + i * n, u + i * n + i, T(0));
+    }
+}
+
+template<typename T>
+void NPMatrix<T>::qrUpdate() const {
+    _qr.reset(new NPMatrix<T>(subMatrix(_i1, _j1, _i2, _j2)));
+    _tau.reset(new vector<T>(_qr->_p));
+
+    size_t n = _qr->_n, p = _qr->_p;
+    T *a = _qr->data();
+
+    // Blocked the same way as the LUP decomposition, the reflectors of a panel are applied at once to the rest
+    for (size_t k1 = 0; k1 < p; k1 += NPMATRIX_QR_NB) {
+        size_t k2 = min<size_t>(k1 + NPMATRIX_QR_NB, p);
+
+        if (n < p || !qrPanel(n, p, a, k1, k2, *_tau)) {
+            _qr.reset(nullptr);
+            _tau.reset(nullptr);
+            return;
+        }
+        if (k2 < p) {
+            qrUpdateTrailing(n, p, a, k1, k2, *_tau);
         }
     }
 }
@@ -633,10 +1461,12 @@ bool NPMatrix<T>::hasDefaultBrowseIndices() const {
 
 template<typename T>
 void NPMatrix<T>::setDefaultBrowseIndices() const {
-    _i1 = 0;
-    _j1 = 0;
-    _i2 = _n - 1;
-    _j2 = _p - 1;
+    if (_i1 != 0 || _j1 != 0 || _i2 != _n - 1 || _j2 != _p - 1) {
+        _i1 = 0;
+        _j1 = 0;
+        _i2 = _n - 1;
+        _j2 = _p - 1;
+    }
     NVector<T>::setDefaultBrowseIndices();
 }
 
@@ -646,12 +1476,12 @@ template<typename T>
 NPMatrix<T> &NPMatrix<T>::copy(const NPMatrix<T> &m) {
     if (this != &m) {
         if (hasDefaultBrowseIndices() && m.hasDefaultBrowseIndices()) {
-            vector<T>::operator=(m);
+            NStorage<T>::operator=(m);
             _n = m._n;
             _p = m._p;
             lupCopy(m);
         } else if (hasDefaultBrowseIndices()) {
-            vector<T>::operator=(m.subMatrix(m._i1, m._j1, m._i2, m._j2));
+            NStorage<T>::operator=(m.subMatrix(m._i1, m._j1, m._i2, m._j2));
             _n = m._i2 - m._i1 + 1;
             _p = m._j2 - m._j1 + 1;
             lupClear();
@@ -677,17 +1507,35 @@ NPMatrix<T> &NPMatrix<T>::copy(const vector<vector<T>> &data) {
     return clean();
 }
 
+template<typename T>
+NPMatrix<T> &NPMatrix<T>::operator=(NPMatrix<T> &&m) {
+    if (this == &m || !hasDefaultBrowseIndices())
+        return copy(m);
+
+    bool whole = m.hasDefaultBrowseIndices();
+    size_t n = whole ? m._n : m._i2 - m._i1 + 1, p = whole ? m._p : m._j2 - m._j1 + 1;
+
+    if (whole) {
+        _a = std::move(m._a);
+        _perm = std::move(m._perm);
+        _chol = std::move(m._chol);
+        _qr = std::move(m._qr);
+        _tau = std::move(m._tau);
+    } else {
+        lupClear();
+    }
+    NStorage<T>::operator=(m.release());
+    _n = n;
+    _p = p;
+    setDefaultBrowseIndices();
+    return *this;
+}
+
 // SUB-MATRICES
 
 template<typename T>
 NPMatrix<T> NPMatrix<T>::subMatrix(size_t i1, size_t j1, size_t i2, size_t j2) const {
-    NPMatrix<T> sub_matrix = NPMatrix<T>::zeros(i2 - i1 + 1, j2 - j1 + 1);
-    for (size_t i = 0; i <= i2 - i1; ++i) {
-        for (size_t j = 0; j <= j2 - j1; ++j) {
-            sub_matrix(i, j) = (*this)(i + i1, j + j1);
-        }
-    }
-    return sub_matrix;
+    return NPMatrix<T>(view(i1, j1, i2, j2));
 }
 
 template<typename T>
@@ -695,34 +1543,30 @@ NPMatrix<T> &NPMatrix<T>::setSubMatrix(const NPMatrix<T> &m) {
     return forEach(m, [](T &x, const T &y) { x = y; });
 }
 
-template<typename T>
-NPMatrix<T> &NPMatrix<T>::forEach(const NPMatrix<T> &m, const function<void(T &, const T &)> &binary_op) {
-    assert(hasSameSize(m));
-
-    for (size_t i = 0; i <= _i2 - _i1; ++i) {
-        for (size_t j = 0; j <= _j2 - _j1; ++j) {
-            binary_op((*this)(i + _i1, j + _j1), m(i + m._i1, j + m._j1));
-        }
-    }
-    return cleanBoth(m);
-}
+NPMatrix<int> product8(const NMatrixView<char> &a, const NMatrixView<char> &b) {
+    assert(a.p() == b.n());
 
-template<typename T>
-NPMatrix<T> &NPMatrix<T>::forEach(T s, const function<void(T &, T)> &binary_op) {
-    for (size_t i = _i1; i <= _i2; ++i) {
-        for (size_t j = _j1; j <= _j2; ++j) {
-            binary_op((*this)(i, j), s);
-        }
-    }
-    return clean();
+    NPMatrix<int> res = NPMatrix<int>::zeros(a.n(), b.p());
+    NBlas::gemm(a.n(), b.p(), a.p(), (const int8_t *) a.data(), a.rowStride(), a.colStride(),
+                (const int8_t *) b.data(), b.rowStride(), b.colStride(), res.data(), b.p());
+    return res;
 }
 
+NPMatrix<int> product8(const NMatrixView<uc_t> &a, const NMatrixView<char> &b) {
+    assert(a.p() == b.n());
 
-
+    NPMatrix<int> res = NPMatrix<int>::zeros(a.n(), b.p());
+    NBlas::gemm(a.n(), b.p(), a.p(), (const uint8_t *) a.data(), a.rowStride(), a.colStride(),
+                (const int8_t *) b.data(), b.rowStride(), b.colStride(), res.data(), b.p());
+    return res;
+}
 
 template
 class NPMatrix<double_t>;
 
+template
+class NPMatrix<float>;
+
 template
 class NPMatrix<char>;
 
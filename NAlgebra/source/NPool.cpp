@@ -0,0 +1,112 @@
+//
+// Created by bendou on 30/01/19.
+//
+
+#include <NPool.h>
+#include <NAllocator.h>
+
+using namespace std;
+
+// Set on the threads of the pools, tasks can't start a parallel run
+static thread_local bool in_pool = false;
+
+NPool &NPool::instance() {
+    static NPool pool;
+    return pool;
+}
+
+NPool::NPool(size_t threads) : _task(nullptr), _count(0), _batch(0), _active(0), _next{0}, _stop(false) {
+    start(threads);
+}
+
+NPool::~NPool() {
+    stop();
+}
+
+void NPool::resize(size_t threads) {
+    lock_guard<mutex> busy(_busy);
+    stop();
+    start(threads);
+}
+
+void NPool::run(size_t count, const function<void(size_t)> &task) {
+    unique_lock<mutex> busy(_busy, defer_lock);
+
+    if (count <= 1 || _workers.empty() || in_pool || !busy.try_lock()) {
+        for (size_t k = 0; k < count; ++k) {
+            task(k);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(_mutex);
+        _task = &task;
+        _count = count;
+        _next = 0;
+        _active = _workers.size();
+        _batch++;
+    }
+    _wake.notify_all();
+
+    in_pool = true;
+    drain();
+    in_pool = false;
+
+    // The task must outlive the workers still running it
+    unique_lock<mutex> lock(_mutex);
+    _done.wait(lock, [this]() { return _active == 0; });
+    _task = nullptr;
+}
+
+void NPool::start(size_t threads) {
+    if (threads == 0)
+        threads = max<size_t>(1, thread::hardware_concurrency());
+
+    _stop = false;
+    for (size_t t = 1; t < threads; ++t) {
+        _workers.emplace_back(&NPool::work, this);
+    }
+}
+
+void NPool::stop() {
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for (auto &worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+void NPool::work() {
+    size_t batch = 0;
+
+    in_pool = true;
+    for (;;) {
+        {
+            unique_lock<mutex> lock(_mutex);
+            _wake.wait(lock, [this, batch]() { return _stop || _batch != batch; });
+            if (_stop)
+                return;
+            batch = _batch;
+        }
+
+        drain();
+
+        lock_guard<mutex> lock(_mutex);
+        if (--_active == 0)
+            _done.notify_one();
+    }
+}
+
+void NPool::drain() {
+    // Scratch buffers of the tasks are reused from a task to another and freed at the end of the run
+    NArena::Scope scratch;
+
+    for (size_t k = _next++; k < _count; k = _next++) {
+        (*_task)(k);
+    }
+}
@@ -3,6 +3,7 @@
 //
 
 #include <NVector.h>
+#include <NBlas.h>
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wabsolute-value"
@@ -40,76 +41,177 @@ std::vector<T> NVector<T>::array() const {
     return res;
 }
 
+// REDUCTIONS
+
+// Reductions of n contiguous components, double and single precision ones being vectorized by NBlas
+
+template<typename T>
+static T arraySum(size_t n, const T *x) {
+    T sum = 0;
+    for (size_t k = 0; k < n; ++k) {
+        sum += x[k];
+    }
+    return sum;
+}
+
+static double_t arraySum(size_t n, const double_t *x) {
+    return NBlas::sum(n, x);
+}
+
+static float arraySum(size_t n, const float *x) {
+    return NBlas::sum(n, x);
+}
+
+template<typename T>
+static T arrayDot(size_t n, const T *x, const T *y) {
+    T dot = 0;
+    for (size_t k = 0; k < n; ++k) {
+        dot += x[k] * y[k];
+    }
+    return dot;
+}
+
+static double_t arrayDot(size_t n, const double_t *x, const double_t *y) {
+    return NBlas::dot(n, x, y);
+}
+
+static float arrayDot(size_t n, const float *x, const float *y) {
+    return NBlas::dot(n, x, y);
+}
+
+template<typename T>
+static void arrayMinmax(size_t n, const T *x, size_t &imin, size_t &imax) {
+    imin = imax = 0;
+    for (size_t k = 1; k < n; ++k) {
+        if (x[k] < x[imin])
+            imin = k;
+        if (x[k] > x[imax])
+            imax = k;
+    }
+}
+
+static void arrayMinmax(size_t n, const double_t *x, size_t &imin, size_t &imax) {
+    NBlas::minmax(n, x, imin, imax);
+}
+
+static void arrayMinmax(size_t n, const float *x, size_t &imin, size_t &imax) {
+    NBlas::minmax(n, x, imin, imax);
+}
+
+template<typename T>
+static void arrayMinmaxAbs(size_t n, const T *x, size_t &imin, size_t &imax) {
+    imin = imax = 0;
+    for (size_t k = 1; k < n; ++k) {
+        if (abs(x[k]) < abs(x[imin]))
+            imin = k;
+        if (abs(x[k]) > abs(x[imax]))
+            imax = k;
+    }
+}
+
+static void arrayMinmaxAbs(size_t n, const double_t *x, size_t &imin, size_t &imax) {
+    NBlas::minmaxAbs(n, x, imin, imax);
+}
+
+static void arrayMinmaxAbs(size_t n, const float *x, size_t &imin, size_t &imax) {
+    NBlas::minmaxAbs(n, x, imin, imax);
+}
+
+template<typename T>
+static void arrayCombine(size_t n, size_t count, const T *const *x, const T *s, T *y) {
+    for (size_t k = 0; k < count; ++k) {
+        for (size_t l = 0; l < n; ++l) {
+            y[l] += s[k] * x[k][l];
+        }
+    }
+}
+
+static void arrayCombine(size_t n, size_t count, const double_t *const *x, const double_t *s, double_t *y) {
+    NBlas::combine(n, count, x, s, y);
+}
+
+static void arrayCombine(size_t n, size_t count, const float *const *x, const float *s, float *y) {
+    NBlas::combine(n, count, x, s, y);
+}
+
+template<typename T>
+T NVector<T>::sum() const {
+    T sum = this->empty() ? T(0) : arraySum(_k2 - _k1 + 1, this->data() + _k1);
+    setDefaultBrowseIndices();
+    return sum;
+}
+
 // MAX / MIN
 
 template<typename T>
-T NVector<T>::max() const {
-    auto res_it = std::max_element(begin(), end());
+pair<size_t, size_t> NVector<T>::minmaxIndex() const {
+    size_t imin, imax;
+
+    assert(!this->empty());
+    arrayMinmax(_k2 - _k1 + 1, this->data() + _k1, imin, imax);
     setDefaultBrowseIndices();
-    return *res_it;
+    return make_pair(imin, imax);
+}
+
+template<typename T>
+pair<T, T> NVector<T>::minmax() const {
+    const T *x = this->data() + _k1;
+    pair<size_t, size_t> index = minmaxIndex();
+    return make_pair(x[index.first], x[index.second]);
+}
+
+template<typename T>
+T NVector<T>::max() const {
+    return minmax().second;
 }
 
 template<typename T>
 T NVector<T>::min() const {
-    auto res_it = std::min_element(begin(), end());
-    setDefaultBrowseIndices();
-    return *res_it;
+    return minmax().first;
 }
 
 template<typename T>
 size_t NVector<T>::maxIndex() const {
-    auto max_it = std::max_element(begin(), end());
-    auto res = (size_t) std::distance(begin(), max_it);
-    setDefaultBrowseIndices();
-    return res;
+    return minmaxIndex().second;
 }
 
 template<typename T>
 size_t NVector<T>::minIndex() const {
-    auto min_it = std::min_element(begin(), end());
-    size_t res = (size_t) std::distance(begin(), min_it);
-    setDefaultBrowseIndices();
-    return res;
+    return minmaxIndex().first;
 }
 
 // ABSOLUTE VALUE MAX / MIN
 
 template<typename T>
-T NVector<T>::maxAbs() const {
-
-    auto minmax_it = std::minmax_element(begin(), end());
+pair<size_t, size_t> NVector<T>::minmaxAbsIndex() const {
+    size_t imin, imax;
 
+    assert(!this->empty());
+    arrayMinmaxAbs(_k2 - _k1 + 1, this->data() + _k1, imin, imax);
     setDefaultBrowseIndices();
-    return abs(*minmax_it.second) > abs(*minmax_it.first) ? abs(*minmax_it.second) : abs(*minmax_it.first);
+    return make_pair(imin, imax);
 }
 
 template<typename T>
-T NVector<T>::minAbs() const {
-
-    auto minmax_it = std::minmax_element(begin(), end());
+T NVector<T>::maxAbs() const {
+    const T *x = this->data() + _k1;
+    return abs(x[minmaxAbsIndex().second]);
+}
 
-    setDefaultBrowseIndices();
-    return abs(*minmax_it.second) <= abs(*minmax_it.first) ? abs(*minmax_it.second) : abs(*minmax_it.first);
+template<typename T>
+T NVector<T>::minAbs() const {
+    const T *x = this->data() + _k1;
+    return abs(x[minmaxAbsIndex().first]);
 }
 
 template<typename T>
 size_t NVector<T>::maxAbsIndex() const {
-    auto min_it = std::min_element(begin(), end()), max_it = std::max_element(begin(), end());
-
-    size_t res = (size_t) std::distance(begin(), (abs(*min_it) > abs(*max_it)) ? min_it : max_it);
-    setDefaultBrowseIndices();
-
-    return res;
+    return minmaxAbsIndex().second;
 }
 
 template<typename T>
 size_t NVector<T>::minAbsIndex() const {
-    auto min_it = std::min_element(begin(), end()), max_it = std::max_element(begin(), end());
-
-    size_t res = (size_t) std::distance(begin(), (abs(*min_it) <= abs(*max_it)) ? min_it : max_it);
-    setDefaultBrowseIndices();
-
-    return res;
+    return minmaxAbsIndex().first;
 }
 
 
@@ -181,6 +283,16 @@ NVector<T> &NVector<T>::operator()(size_t k1, size_t k2) {
 
 // AFFECTATION
 
+template<typename T>
+NVector<T> &NVector<T>::operator=(NVector<T> &&u) {
+    if (this == &u || u.empty() || !hasDefaultBrowseIndices())
+        return copy(u);
+
+    NStorage<T>::operator=(u.release());
+    setDefaultBrowseIndices();
+    return *this;
+}
+
 // STATIC METHODS
 
 template<typename T>
@@ -201,23 +313,24 @@ NVector<T> NVector<T>::cano(size_t k, size_t dim) {
 
 template<typename T>
 NVector<T> NVector<T>::sum(const std::vector<NVector> &vectors) {
-    NVector<T> sum = NVector<T>::zeros(vectors[0].dim());
-
-    for (const auto &vector : vectors) {
-        sum += vector;
-    }
-    return sum;
+    return sumProd(std::vector<T>(vectors.size(), T(1)), vectors);
 }
 
 template<typename T>
 NVector<T> NVector<T>::sumProd(const std::vector<T> &scalars, const std::vector<NVector> &vectors) {
-    NVector<T> sum_prod = NVector<T>::zeros(vectors[0].dim());
+    // dim() would reset the browse indices of the first vector before its components are read
+    NVector<T> sum_prod = NVector<T>::zeros(vectors[0].empty() ? 0 : vectors[0]._k2 - vectors[0]._k1 + 1);
+    std::vector<const T *> data(vectors.size());
 
     assert(scalars.size() == vectors.size());
 
-    for (size_t k = 0; k < scalars.size(); ++k) {
-        sum_prod += scalars[k] * vectors[k];
+    // All the vectors are combined at once by blocks of components
+    for (size_t k = 0; k < vectors.size(); ++k) {
+        assert(vectors[k].hasSameSize(sum_prod));
+        data[k] = vectors[k].data() + vectors[k]._k1;
+        vectors[k].setDefaultBrowseIndices();
     }
+    arrayCombine(sum_prod.size(), vectors.size(), data.data(), scalars.data(), sum_prod.data());
     return sum_prod;
 }
 
@@ -225,46 +338,38 @@ NVector<T> NVector<T>::sumProd(const std::vector<T> &scalars, const std::vector<
 
 
 template<typename T>
-NVector<T>::NVector(const vector<T> &data, size_t k1, size_t k2) : vector<T>(data), _k1(k1), _k2(k2) {
+NVector<T>::NVector(const NStorage<T> &data, size_t k1, size_t k2) : NStorage<T>(data), _k1(k1), _k2(k2) {
     setDefaultBrowseIndices();
 }
 
-// EUCLIDEAN SPACE OPERATIONS
+template<typename T>
+NVector<T>::NVector(NStorage<T> &&data, size_t k1, size_t k2) : NStorage<T>(std::move(data)), _k1(k1), _k2(k2) {
+    setDefaultBrowseIndices();
+}
 
 template<typename T>
-T NVector<T>::dotProduct(const NVector<T> &u) const {
-    T dot = 0;
+NStorage<T> NVector<T>::release() {
+    bool whole = NVector<T>::hasDefaultBrowseIndices();
+    NStorage<T> data(std::move(static_cast<NStorage<T> &>(*this)));
 
-    assert(hasSameSize(u));
-    for (size_t k = 0; k <= _k2 - _k1; ++k) {
-        dot += u[k + u._k1] * (*this)[k + _k1];
+    if (!whole) {
+        data.erase(data.begin() + _k2 + 1, data.end());
+        data.erase(data.begin(), data.begin() + _k1);
     }
+    this->clear();
     setDefaultBrowseIndices();
-    u.setDefaultBrowseIndices();
-    return dot;
+    return data;
 }
 
-// MANIPULATORS
-
+// EUCLIDEAN SPACE OPERATIONS
 
 template<typename T>
-NVector<T> &NVector<T>::forEach(const NVector<T> &u, const std::function<void(T &, const T &)> &binary_op) {
+T NVector<T>::dotProduct(const NVector<T> &u) const {
     assert(hasSameSize(u));
-    for (size_t k = 0; k <= _k2 - _k1; k++) {
-        binary_op((*this)[k + _k1], u[k + u._k1]);
-    }
+    T dot = this->empty() ? T(0) : arrayDot(_k2 - _k1 + 1, this->data() + _k1, u.data() + u._k1);
     setDefaultBrowseIndices();
     u.setDefaultBrowseIndices();
-    return *this;
-}
-
-template<typename T>
-NVector<T> &NVector<T>::forEach(T s, const std::function<void(T &, T)> &binary_op) {
-    for (size_t k = 0; k <= _k2 - _k1; k++) {
-        binary_op((*this)[k + _k1], s);
-    }
-    setDefaultBrowseIndices();
-    return *this;
+    return dot;
 }
 
 //CHARACTERIZATION
@@ -282,9 +387,9 @@ template<typename T>
 NVector<T> &NVector<T>::copy(const NVector<T> &u) {
     if (this != &u && u.size() > 0) {
         if (hasDefaultBrowseIndices() && u.hasDefaultBrowseIndices()) {
-            this->std::vector<T>::operator=(u);
+            this->NStorage<T>::operator=(u);
         } else if (hasDefaultBrowseIndices()) {
-            this->std::vector<T>::operator=(u.subVector(u._k1, u._k2));
+            this->NStorage<T>::operator=(u.subVector(u._k1, u._k2));
         } else {
             setSubVector(u);
         }
@@ -304,8 +409,7 @@ NVector<T> NVector<T>::subVector(size_t k1, size_t k2) const {
 
     assert(isValidIndex(k1) && isValidIndex(k2) && dim > 0);
 
-    vector<T> data(dim);
-    std::copy(begin(), end(), data.begin());
+    NStorage<T> data(begin(), end());
     setDefaultBrowseIndices();
 
     return data;
@@ -325,6 +429,9 @@ void NVector<T>::setSubVector(const NVector<T> &u) {
 template
 class NVector<double_t>;
 
+template
+class NVector<float>;
+
 template
 class NVector<char>;
 
@@ -0,0 +1,244 @@
+//
+// Created by bendou on 03/02/19.
+//
+
+#include <Vector3Batch.h>
+#include <NLanes.h>
+
+using namespace std;
+
+// Kernels on the vectors [k, k + L::size) of the batches, run with the widest lanes available by forLanes
+
+struct NDot {
+    const double_t *ux, *uy, *uz, *vx, *vy, *vz;
+    double_t *r;
+
+    template<typename L>
+    inline void lanes(size_t k) const {
+        L::store(r + k, L::fmadd(L::load(ux + k), L::load(vx + k),
+                                 L::fmadd(L::load(uy + k), L::load(vy + k), L::mul(L::load(uz + k), L::load(vz + k)))));
+    }
+};
+
+struct NCross {
+    const double_t *ux, *uy, *uz, *vx, *vy, *vz;
+    double_t *rx, *ry, *rz;
+
+    template<typename L>
+    inline void lanes(size_t k) const {
+        typename L::type x1 = L::load(ux + k), y1 = L::load(uy + k), z1 = L::load(uz + k);
+        typename L::type x2 = L::load(vx + k), y2 = L::load(vy + k), z2 = L::load(vz + k);
+
+        L::store(rx + k, L::fnmadd(z1, y2, L::mul(y1, z2)));
+        L::store(ry + k, L::fnmadd(x1, z2, L::mul(z1, x2)));
+        L::store(rz + k, L::fnmadd(y1, x2, L::mul(x1, y2)));
+    }
+};
+
+struct NNorm {
+    const double_t *ux, *uy, *uz;
+    double_t *r;
+
+    template<typename L>
+    inline void lanes(size_t k) const {
+        typename L::type x = L::load(ux + k), y = L::load(uy + k), z = L::load(uz + k);
+
+        L::store(r + k, L::sqrt(L::fmadd(z, z, L::fmadd(x, x, L::mul(y, y)))));
+    }
+};
+
+// Scale by s when scalars is null, by the components of scalars otherwise
+struct NScale {
+    const double_t *ux, *uy, *uz, *scalars;
+    double_t s;
+    double_t *rx, *ry, *rz;
+
+    template<typename L>
+    inline void lanes(size_t k) const {
+        typename L::type f = scalars != nullptr ? L::load(scalars + k) : L::set(s);
+
+        L::store(rx + k, L::mul(f, L::load(ux + k)));
+        L::store(ry + k, L::mul(f, L::load(uy + k)));
+        L::store(rz + k, L::mul(f, L::load(uz + k)));
+    }
+};
+
+// u + s v
+struct NAxpy {
+    const double_t *ux, *uy, *uz, *vx, *vy, *vz;
+    double_t s;
+    double_t *rx, *ry, *rz;
+
+    template<typename L>
+    inline void lanes(size_t k) const {
+        typename L::type f = L::set(s);
+
+        L::store(rx + k, L::fmadd(f, L::load(vx + k), L::load(ux + k)));
+        L::store(ry + k, L::fmadd(f, L::load(vy + k), L::load(uy + k)));
+        L::store(rz + k, L::fmadd(f, L::load(vz + k), L::load(uz + k)));
+    }
+};
+
+struct NApply {
+    const double_t *m, *ux, *uy, *uz;
+    double_t *rx, *ry, *rz;
+
+    template<typename L>
+    inline void lanes(size_t k) const {
+        typename L::type x = L::load(ux + k), y = L::load(uy + k), z = L::load(uz + k);
+        double_t *r[] = {rx, ry, rz};
+
+        for (size_t i = 0; i < 3; ++i) {
+            L::store(r[i] + k, L::fmadd(L::set(m[3 * i]), x,
+                                        L::fmadd(L::set(m[3 * i + 1]), y, L::mul(L::set(m[3 * i + 2]), z))));
+        }
+    }
+};
+
+template<typename F>
+static void forLanes(size_t size, const F &f) {
+    size_t k = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+    for (; k + NLanes::size <= size; k += NLanes::size) {
+        f.template lanes<NLanes>(k);
+    }
+#endif
+    for (; k < size; ++k) {
+        f.template lanes<NLane>(k);
+    }
+}
+
+Vector3Batch::Vector3Batch(size_t size) : _x(size), _y(size), _z(size) {}
+
+Vector3Batch::Vector3Batch(const vector<Vector3> &vectors) : Vector3Batch(vectors.size()) {
+    for (size_t k = 0; k < vectors.size(); ++k) {
+        set(k, vectors[k]);
+    }
+}
+
+Vector3Batch::Vector3Batch(initializer_list<Vector3> list) : Vector3Batch(vector<Vector3>(list)) {}
+
+vector<Vector3> Vector3Batch::vectors() const {
+    vector<Vector3> vectors(size());
+
+    for (size_t k = 0; k < size(); ++k) {
+        vectors[k] = (*this)[k];
+    }
+    return vectors;
+}
+
+string Vector3Batch::str() const {
+    stringstream stream;
+
+    for (size_t k = 0; k < size(); ++k) {
+        stream << "\n" << (*this)[k];
+    }
+    return stream.str();
+}
+
+void Vector3Batch::resize(size_t size) {
+    _x.resize(size);
+    _y.resize(size);
+    _z.resize(size);
+}
+
+void Vector3Batch::push_back(const Vector3 &u) {
+    _x.push_back(u.x());
+    _y.push_back(u.y());
+    _z.push_back(u.z());
+}
+
+vec_t Vector3Batch::theta() const {
+    vec_t r(size());
+
+    theta(*this, r.data());
+    return r;
+}
+
+vec_t Vector3Batch::phi() const {
+    vec_t r(size());
+
+    phi(*this, r.data());
+    return r;
+}
+
+vec_t operator|(const Vector3Batch &u, const Vector3Batch &v) {
+    vec_t r(u.size());
+
+    Vector3Batch::dot(u, v, r.data());
+    return r;
+}
+
+vec_t operator!(const Vector3Batch &u) {
+    vec_t r(u.size());
+
+    Vector3Batch::norm(u, r.data());
+    return r;
+}
+
+Vector3Batch &Vector3Batch::operator+=(const Vector3Batch &u) {
+    assert(u.size() == size());
+    forLanes(size(), NAxpy{x(), y(), z(), u.x(), u.y(), u.z(), 1, x(), y(), z()});
+    return *this;
+}
+
+Vector3Batch &Vector3Batch::operator-=(const Vector3Batch &u) {
+    assert(u.size() == size());
+    forLanes(size(), NAxpy{x(), y(), z(), u.x(), u.y(), u.z(), -1, x(), y(), z()});
+    return *this;
+}
+
+void Vector3Batch::dot(const Vector3Batch &u, const Vector3Batch &v, double_t *r) {
+    assert(u.size() == v.size());
+    forLanes(u.size(), NDot{u.x(), u.y(), u.z(), v.x(), v.y(), v.z(), r});
+}
+
+void Vector3Batch::cross(const Vector3Batch &u, const Vector3Batch &v, Vector3Batch &r) {
+    assert(u.size() == v.size() && u.size() == r.size());
+    forLanes(u.size(), NCross{u.x(), u.y(), u.z(), v.x(), v.y(), v.z(), r.x(), r.y(), r.z()});
+}
+
+void Vector3Batch::norm(const Vector3Batch &u, double_t *r) {
+    forLanes(u.size(), NNorm{u.x(), u.y(), u.z(), r});
+}
+
+void Vector3Batch::scale(const Vector3Batch &u, double_t s, Vector3Batch &r) {
+    assert(u.size() == r.size());
+    forLanes(u.size(), NScale{u.x(), u.y(), u.z(), nullptr, s, r.x(), r.y(), r.z()});
+}
+
+void Vector3Batch::scale(const Vector3Batch &u, const double_t *s, Vector3Batch &r) {
+    assert(u.size() == r.size());
+    forLanes(u.size(), NScale{u.x(), u.y(), u.z(), s, 0, r.x(), r.y(), r.z()});
+}
+
+void Vector3Batch::theta(const Vector3Batch &u, double_t *r) {
+    const double_t *x = u.x(), *y = u.y();
+
+    for (size_t k = 0; k < u.size(); ++k) {
+        r[k] = atan2(y[k], x[k]);
+    }
+}
+
+void Vector3Batch::phi(const Vector3Batch &u, double_t *r) {
+    const double_t *x = u.x(), *y = u.y(), *z = u.z();
+
+    // Components are read before r[k] is written, r can be one of the arrays of u
+    for (size_t k = 0; k < u.size(); ++k) {
+        r[k] = atan2(sqrt(x[k] * x[k] + y[k] * y[k]), z[k]);
+    }
+}
+
+void Vector3Batch::apply(const Matrix3 &m, const Vector3Batch &u, Vector3Batch &r) {
+    assert(u.size() == r.size());
+    forLanes(u.size(), NApply{m.data(), u.x(), u.y(), u.z(), r.x(), r.y(), r.z()});
+}
+
+Vector3Batch Vector3Batch::scalar(double_t scalar, size_t size) {
+    Vector3Batch u(size);
+
+    fill(u._x.begin(), u._x.end(), scalar);
+    fill(u._y.begin(), u._y.end(), scalar);
+    fill(u._z.begin(), u._z.end(), scalar);
+    return u;
+}
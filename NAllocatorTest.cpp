@@ -0,0 +1,37 @@
+//
+// Created by Sami Dahoux on 2019-02-05.
+//
+
+#include <gtest/gtest.h>
+#include <NAllocator.h>
+
+using namespace std;
+
+TEST(NAllocatorTest, Arena) {
+    NArena &arena = NArena::local();
+    size_t capacity = arena.capacity();
+
+    {
+        NArena::Scope outer;
+        double_t *x = outer.alloc<double_t>(10);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(x) % NALLOCATOR_ALIGNMENT, 0);
+        EXPECT_EQ(x[9], 0);
+
+        // Large blocks are reused by the next scopes until the outermost one ends
+        {
+            NArena::Scope inner;
+            inner.alloc<char>(4 * NARENA_BLOCK);
+        }
+        size_t reserved = arena.capacity();
+        EXPECT_GE(reserved, 4 * NARENA_BLOCK);
+        {
+            NArena::Scope inner;
+            inner.alloc<char>(4 * NARENA_BLOCK);
+        }
+        EXPECT_EQ(arena.capacity(), reserved);
+    }
+
+    // Only the blocks of NARENA_BLOCK bytes are kept
+    EXPECT_LE(arena.capacity(), max<size_t>(capacity, NARENA_BLOCK));
+    EXPECT_EQ(arena.capacity() % NARENA_BLOCK, 0);
+}
@@ -0,0 +1,317 @@
+//
+// Created by Sami Dahoux on 2019-02-05.
+//
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <NBlas.h>
+#include <NPool.h>
+
+using namespace std;
+
+// Shapes n x p x k around the blocking sizes, below NBLAS_GEMM_MIN and on a single row or column
+static const vector<vector<size_t>> gemm_shapes{{97, 131, 259}, {301, 257, 7}, {7, 9, 257}, {6, 8, 256},
+                                               {13, 5, 11}, {1, 300, 1}, {300, 1, 40}, {1, 1, 1}};
+
+template<typename T>
+static vector<T> random(size_t size, double low, double high, unsigned seed) {
+    mt19937 generator(seed);
+    uniform_real_distribution<double> distribution(low, high);
+    vector<T> x(size);
+
+    for (auto &value : x) {
+        value = (T) distribution(generator);
+    }
+    return x;
+}
+
+// C = C + A B with the component (i, j) of A at a[i * rsa + j * csa] and the one of B at b[i * rsb + j * csb]
+template<typename TA, typename TB, typename TC>
+static void naiveGemm(size_t n, size_t p, size_t k, const TA *a, size_t rsa, size_t csa,
+                      const TB *b, size_t rsb, size_t csb, TC *c, size_t ldc) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < p; ++j) {
+            TC sum = 0;
+            for (size_t l = 0; l < k; ++l) {
+                sum += (TC) a[i * rsa + l * csa] * (TC) b[l * rsb + j * csb];
+            }
+            c[i * ldc + j] += sum;
+        }
+    }
+}
+
+template<typename T>
+static void expectNear(const vector<T> &expected, const vector<T> &actual, double tolerance) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t k = 0; k < expected.size(); ++k) {
+        ASSERT_NEAR(expected[k], actual[k], tolerance) << "at " << k;
+    }
+}
+
+// Sub-matrices of larger arrays, each leading dimension is padded by 3 components
+template<typename T>
+static void testGemm(double tolerance) {
+    for (const auto &shape : gemm_shapes) {
+        size_t n = shape[0], p = shape[1], k = shape[2], lda = k + 3, ldb = p + 3, ldc = p + 3;
+        vector<T> a = random<T>(n * lda, -1, 1, 1), b = random<T>(k * ldb, -1, 1, 2);
+        vector<T> c = random<T>(n * ldc, -1, 1, 3), expected = c;
+
+        NBlas::gemm(n, p, k, a.data(), lda, b.data(), ldb, c.data(), ldc);
+        naiveGemm(n, p, k, a.data(), lda, (size_t) 1, b.data(), ldb, (size_t) 1, expected.data(), ldc);
+        expectNear(expected, c, tolerance * k);
+    }
+}
+
+template<typename T>
+static void testGemmStrided(double tolerance) {
+    for (const auto &shape : gemm_shapes) {
+        size_t n = shape[0], p = shape[1], k = shape[2];
+        vector<T> a = random<T>(n * k, -1, 1, 4), b = random<T>(k * p, -1, 1, 5);
+
+        // Column-major A times row-major B, then row-major A times column-major B
+        vector<T> c(n * p), expected(n * p);
+        NBlas::gemm(n, p, k, a.data(), 1, n, b.data(), p, 1, c.data(), p);
+        naiveGemm(n, p, k, a.data(), (size_t) 1, n, b.data(), p, (size_t) 1, expected.data(), p);
+        expectNear(expected, c, tolerance * k);
+
+        vector<T> ct(n * p), expected_t(n * p);
+        NBlas::gemm(n, p, k, a.data(), k, 1, b.data(), 1, k, ct.data(), p);
+        naiveGemm(n, p, k, a.data(), k, (size_t) 1, b.data(), (size_t) 1, k, expected_t.data(), p);
+        expectNear(expected_t, ct, tolerance * k);
+    }
+}
+
+TEST(NBlasTest, Gemm) {
+    testGemm<double_t>(1e-13);
+    testGemm<float>(1e-5);
+}
+
+TEST(NBlasTest, GemmStrided) {
+    testGemmStrided<double_t>(1e-13);
+    testGemmStrided<float>(1e-5);
+}
+
+TEST(NBlasTest, GemmInt8) {
+    for (const auto &shape : gemm_shapes) {
+        size_t n = shape[0], p = shape[1], k = shape[2], lda = k + 3, ldb = p + 3;
+        vector<int8_t> a = random<int8_t>(n * lda, -128, 128, 6), b = random<int8_t>(k * ldb, -128, 128, 7);
+        vector<uint8_t> ua = random<uint8_t>(n * lda, 0, 256, 8);
+        vector<int32_t> c(n * p, 1), expected(n * p, 1), uc(n * p, -1), expected_u(n * p, -1);
+
+        // Extreme values, the products of 8-bit integers must not saturate
+        a[0] = -128;
+        b[0] = -128;
+        ua[0] = 255;
+
+        NBlas::gemm(n, p, k, a.data(), lda, b.data(), ldb, c.data(), p);
+        naiveGemm(n, p, k, a.data(), lda, (size_t) 1, b.data(), ldb, (size_t) 1, expected.data(), p);
+        ASSERT_EQ(expected, c);
+
+        NBlas::gemm(n, p, k, ua.data(), lda, b.data(), ldb, uc.data(), p);
+        naiveGemm(n, p, k, ua.data(), lda, (size_t) 1, b.data(), ldb, (size_t) 1, expected_u.data(), p);
+        ASSERT_EQ(expected_u, uc);
+
+        vector<int32_t> ct(n * p), expected_t(n * p);
+        NBlas::gemm(n, p, k, ua.data(), 1, n, b.data(), 1, k, ct.data(), p);
+        naiveGemm(n, p, k, ua.data(), (size_t) 1, n, b.data(), (size_t) 1, k, expected_t.data(), p);
+        ASSERT_EQ(expected_t, ct);
+    }
+}
+
+TEST(NBlasTest, GemmThreads) {
+    size_t n = 301, p = 199, k = 257;
+    vector<double_t> a = random<double_t>(n * k, -1, 1, 9), b = random<double_t>(k * p, -1, 1, 10);
+    vector<double_t> serial(n * p), expected(n * p);
+
+    NPool::instance().resize(1);
+    NBlas::gemm(n, p, k, a.data(), k, b.data(), p, serial.data(), p);
+    naiveGemm(n, p, k, a.data(), k, (size_t) 1, b.data(), p, (size_t) 1, expected.data(), p);
+    expectNear(expected, serial, 1e-13 * k);
+
+    // Blocks are shared between the threads, the result does not depend on their number
+    for (size_t threads : {2, 3, 7}) {
+        vector<double_t> c(n * p);
+
+        NPool::instance().resize(threads);
+        NBlas::gemm(n, p, k, a.data(), k, b.data(), p, c.data(), p);
+        ASSERT_EQ(serial, c);
+    }
+    NPool::instance().resize(0);
+}
+
+template<typename T>
+static void testGemv(double tolerance) {
+    for (const auto &shape : vector<vector<size_t>>{{1, 1}, {7, 13}, {300, 301}, {65, 1000}, {1000, 3}}) {
+        size_t n = shape[0], p = shape[1], lda = p + 5;
+        vector<T> a = random<T>(n * lda, -1, 1, 11), x = random<T>(p, -1, 1, 12), xt = random<T>(n, -1, 1, 13);
+        vector<T> y = random<T>(n, -1, 1, 14), yt = random<T>(p, -1, 1, 15), expected = y, expected_t = yt;
+
+        NBlas::gemv(n, p, a.data(), lda, x.data(), y.data());
+        naiveGemm(n, (size_t) 1, p, a.data(), lda, (size_t) 1, x.data(), (size_t) 1, (size_t) 1, expected.data(), 1);
+        expectNear(expected, y, tolerance * p);
+
+        // y = y + A^T x reads A by rows
+        NBlas::gemvT(n, p, a.data(), lda, xt.data(), yt.data());
+        naiveGemm(p, (size_t) 1, n, a.data(), (size_t) 1, lda, xt.data(), (size_t) 1, (size_t) 1,
+                  expected_t.data(), 1);
+        expectNear(expected_t, yt, tolerance * n);
+    }
+}
+
+TEST(NBlasTest, Gemv) {
+    testGemv<double_t>(1e-13);
+    testGemv<float>(1e-5);
+}
+
+// Counts around the groups of 4 arrays, sizes on one and several blocks, the last ones take the parallel path
+template<typename T>
+static void testCombine(double tolerance) {
+    for (size_t count : {1, 3, 4, 5, 7, 9}) {
+        for (size_t n : {1, 7, NBLAS_COMBINE_NB - 1, NBLAS_COMBINE_NB + 3, 3 * NBLAS_COMBINE_NB + 5, 9000, 20003}) {
+            vector<vector<T>> rows(count);
+            vector<const T *> x(count);
+            vector<T> s = random<T>(count, -2, 2, 21), y = random<T>(n, -1, 1, 22), expected = y;
+
+            for (size_t k = 0; k < count; ++k) {
+                rows[k] = random<T>(n, -1, 1, 23 + (unsigned) k);
+                x[k] = rows[k].data();
+                for (size_t j = 0; j < n; ++j) {
+                    expected[j] += s[k] * rows[k][j];
+                }
+            }
+            NBlas::combine(n, count, x.data(), s.data(), y.data());
+            expectNear(expected, y, tolerance * count);
+        }
+    }
+}
+
+TEST(NBlasTest, Combine) {
+    testCombine<double_t>(1e-14);
+    testCombine<float>(1e-5);
+}
+
+TEST(NBlasTest, CombineThreads) {
+    size_t n = 20003, count = 7;
+    vector<vector<double_t>> rows(count);
+    vector<const double_t *> x(count);
+    vector<double_t> s = random<double_t>(count, -2, 2, 30), serial(n);
+
+    for (size_t k = 0; k < count; ++k) {
+        rows[k] = random<double_t>(n, -1, 1, 31 + (unsigned) k);
+        x[k] = rows[k].data();
+    }
+    NPool::instance().resize(1);
+    NBlas::combine(n, count, x.data(), s.data(), serial.data());
+
+    // Each component is combined by a single thread in the order of the arrays
+    for (size_t threads : {2, 3, 7}) {
+        vector<double_t> y(n);
+
+        NPool::instance().resize(threads);
+        NBlas::combine(n, count, x.data(), s.data(), y.data());
+        ASSERT_EQ(serial, y);
+    }
+    NPool::instance().resize(0);
+}
+
+// Shapes around the 4 x 4 and 8 x 8 register kernels and the cache blocks, the padding of B must be left untouched
+template<typename T>
+static void testTranspose() {
+    for (size_t n : {1, 3, 4, 5, 7, 8, 9, 31, NBLAS_TRANSPOSE_NB, NBLAS_TRANSPOSE_NB + 1, 2 * NBLAS_TRANSPOSE_NB + 3}) {
+        for (size_t p : {1, 4, 6, 8, 13, NBLAS_TRANSPOSE_NB, NBLAS_TRANSPOSE_NB + 1, 70}) {
+            size_t lda = p + 2, ldb = n + 3;
+            vector<T> a = random<T>(n * lda, -1, 1, 16), b(p * ldb, -2);
+
+            NBlas::transpose(n, p, a.data(), lda, b.data(), ldb);
+            for (size_t i = 0; i < p; ++i) {
+                for (size_t j = 0; j < ldb; ++j) {
+                    ASSERT_EQ(b[i * ldb + j], j < n ? a[j * lda + i] : -2) << n << " x " << p;
+                }
+            }
+        }
+    }
+}
+
+TEST(NBlasTest, Transpose) {
+    testTranspose<double_t>();
+    testTranspose<float>();
+}
+
+// Tails shorter than the lanes, single and several blocks, then the parallel path
+static const vector<size_t> reduce_sizes{1, 2, 3, 5, 7, 8, 9, 17, 33, NBLAS_REDUCE_NB - 1, NBLAS_REDUCE_NB,
+                                         NBLAS_REDUCE_NB + 1, 3 * NBLAS_REDUCE_NB + 5, NBLAS_REDUCE_PARALLEL_MIN + 3};
+
+// Indices of the first minimum and of the first maximum of x, or of its absolute values
+template<typename T>
+static void naiveMinmax(const vector<T> &x, bool abs, size_t &imin, size_t &imax) {
+    auto value = [&](size_t k) { return abs ? std::abs(x[k]) : x[k]; };
+
+    imin = imax = 0;
+    for (size_t k = 1; k < x.size(); ++k) {
+        if (value(k) < value(imin))
+            imin = k;
+        if (value(k) > value(imax))
+            imax = k;
+    }
+}
+
+template<typename T>
+static void testReductions(double tolerance) {
+    for (size_t n : reduce_sizes) {
+        vector<T> x = random<T>(n, -1, 1, 17), y = random<T>(n, -1, 1, 18);
+        long double sum = 0, dot = 0;
+        size_t imin, imax, expected_min, expected_max;
+
+        for (size_t k = 0; k < n; ++k) {
+            sum += x[k];
+            dot += (long double) x[k] * y[k];
+        }
+        ASSERT_NEAR((double) sum, NBlas::sum(n, x.data()), tolerance * n) << n;
+        ASSERT_NEAR((double) dot, NBlas::dot(n, x.data(), y.data()), tolerance * n) << n;
+
+        // Few distinct values, each extremum is met in many lanes and blocks and the first one must win
+        for (auto &value : x) {
+            value = (T) round(8 * value);
+        }
+        for (bool abs : {false, true}) {
+            naiveMinmax(x, abs, expected_min, expected_max);
+            if (abs) {
+                NBlas::minmaxAbs(n, x.data(), imin, imax);
+            } else {
+                NBlas::minmax(n, x.data(), imin, imax);
+            }
+            ASSERT_EQ(expected_min, imin) << n << (abs ? " abs" : "");
+            ASSERT_EQ(expected_max, imax) << n << (abs ? " abs" : "");
+        }
+    }
+}
+
+TEST(NBlasTest, Reductions) {
+    testReductions<double_t>(1e-15);
+    testReductions<float>(1e-6);
+}
+
+TEST(NBlasTest, ReductionsThreads) {
+    size_t n = 2 * NBLAS_REDUCE_PARALLEL_MIN + 7, imin, imax;
+    vector<double_t> x = random<double_t>(n, -1, 1, 19), y = random<double_t>(n, -1, 1, 20);
+
+    NPool::instance().resize(1);
+    double_t sum = NBlas::sum(n, x.data()), dot = NBlas::dot(n, x.data(), y.data());
+    vector<float> xf(x.begin(), x.end());
+    float sumf = NBlas::sum(n, xf.data());
+
+    // Blocks are added in the same order whatever the number of threads, sums are bitwise equal
+    for (size_t threads : {2, 3, 7}) {
+        NPool::instance().resize(threads);
+        ASSERT_EQ(sum, NBlas::sum(n, x.data()));
+        ASSERT_EQ(dot, NBlas::dot(n, x.data(), y.data()));
+        ASSERT_EQ(sumf, NBlas::sum(n, xf.data()));
+
+        NBlas::minmaxAbs(n, x.data(), imin, imax);
+        ASSERT_EQ((size_t) (min_element(x.begin(), x.end(), [](double_t a, double_t b) {
+            return std::abs(a) < std::abs(b);
+        }) - x.begin()), imin);
+    }
+    NPool::instance().resize(0);
+}
@@ -0,0 +1,87 @@
+//
+// Created by Sami Dahoux on 2019-02-05.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Vector3.h>
+
+using namespace std;
+
+TEST(NFixedTest, FromVector) {
+    vec_t u{1, 2, 3, 4, 5};
+    NFixedVector<double_t, 3> v(u(1, 3)), expect_v(2, 3, 4);
+
+    // Only the browsed components are copied, the browse indices of u are reset
+    EXPECT_EQ(v.array(), expect_v.array());
+    EXPECT_EQ(u.dim(), 5);
+
+    NFixedVector<double_t, 5> w(u);
+    EXPECT_EQ(w.array(), u.array());
+}
+
+TEST(NFixedTest, ConstExpr) {
+    constexpr Vector3 u(1, 2, 3), v(4, 5, 6), w = u ^ v;
+    constexpr NFixedMatrix<double_t, 2, 3> a(1, 2, 3, 4, 5, 6);
+    constexpr NFixedVector<double_t, 3> eye_u = NFixedMatrix<double_t, 3, 3>::eye() * u;
+
+    // Computed at compile time, a failure doesn't compile
+    static_assert(w.x() == -3 && w.y() == 6 && w.z() == -3, "cross product");
+    static_assert((u | w) == 0 && (v | w) == 0, "cross product orthogonal to its factors");
+    static_assert(eye_u[0] == 1 && eye_u[1] == 2 && eye_u[2] == 3, "identity");
+    static_assert(a.transposed()(2, 1) == 6 && a.transposed()(0, 1) == 4 && a.transposed().n() == 3, "transposed");
+    static_assert((a * a.transposed())(0, 1) == 32 && (a.transposed() * a)(2, 2) == 45, "products");
+    static_assert((a * u)[1] == 32 && a.row(1)[2] == 6 && a.col(2)[0] == 3, "linear map");
+
+    EXPECT_EQ(w, Vector3(-3, 6, -3));
+    EXPECT_EQ(eye_u, u);
+}
+
+TEST(NFixedTest, NonSquareProduct) {
+    typedef NFixedMatrix<double_t, 2, 3> mat23_t;
+    typedef NFixedVector<double_t, 2> vec2_t;
+    typedef NFixedMatrix<double_t, 2, 2> mat22_t;
+    typedef NFixedMatrix<double_t, 3, 3> mat33_t;
+    mat23_t a(1, 2, 3, 4, 5, 6);
+    NFixedMatrix<double_t, 3, 4> b(1, 0, 2, -1, 0, 1, 1, 2, 3, -1, 0, 1);
+    NFixedMatrix<double_t, 2, 4> expect_ab(10, -1, 4, 6, 22, -1, 13, 12);
+    NFixedVector<double_t, 4> x(1, -1, 2, 0);
+
+    EXPECT_EQ(a * b, expect_ab);
+    EXPECT_EQ((a * b) * x, vec2_t(19, 49));
+    EXPECT_EQ(a * (b * x), (a * b) * x);
+    EXPECT_EQ((a * b).transposed(), b.transposed() * a.transposed());
+    EXPECT_EQ(mat22_t::eye() * a, a);
+    EXPECT_EQ(a * mat33_t::eye(), a);
+    EXPECT_EQ(mat23_t::eye(), mat23_t(1, 0, 0, 0, 1, 0));
+}
+
+TEST(NFixedTest, Vector3Coordinates) {
+    Vector3 u;
+
+    // Cosines and sines of the angles are rounded, components are compared with the distance of the vectors
+    u.setRThetaPhi(2, M_PI / 3, M_PI / 4);
+    EXPECT_NEAR(u / Vector3(M_SQRT2 / 2, M_SQRT2 * sqrt(3) / 2, M_SQRT2), 0, 1e-14);
+    EXPECT_DOUBLE_EQ(u.r(), 2);
+    EXPECT_DOUBLE_EQ(u.theta(), M_PI / 3);
+    EXPECT_DOUBLE_EQ(u.phi(), M_PI / 4);
+
+    // Each spherical coordinate is set keeping the two others
+    u.setR(4);
+    EXPECT_DOUBLE_EQ(u.theta(), M_PI / 3);
+    EXPECT_DOUBLE_EQ(u.phi(), M_PI / 4);
+    u.setTheta(-M_PI / 2);
+    EXPECT_NEAR(u / Vector3(0, -2 * M_SQRT2, 2 * M_SQRT2), 0, 1e-14);
+    u.setPhi(M_PI / 2);
+    EXPECT_NEAR(u / Vector3(0, -4, 0), 0, 1e-14);
+
+    u.setRThetaZ(2, M_PI, 5);
+    EXPECT_NEAR(u / Vector3(-2, 0, 5), 0, 1e-14);
+    EXPECT_NEAR(u.rXY() / Vector3(-2, 0, 0), 0, 1e-14);
+
+    // Angles between two vectors
+    EXPECT_DOUBLE_EQ(Vector3(1, 0, 0) % Vector3(1, 1, 0), M_PI / 4);
+    EXPECT_DOUBLE_EQ(Vector3(0, 0, 2) % Vector3(0, 3, 0), M_PI / 2);
+    EXPECT_DOUBLE_EQ(Vector3(1, 2, 3) % Vector3(2, 4, 6), 0);
+    EXPECT_DOUBLE_EQ(Vector3(1, 2, 3) % Vector3::zeros(), 0);
+}
@@ -0,0 +1,289 @@
+//
+// Created by Sami Dahoux on 2019-02-05.
+//
+
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <NPMatrix.h>
+#include <NBlas.h>
+
+using namespace std;
+
+static mat_t random(size_t n, size_t p, unsigned seed) {
+    mt19937 generator(seed);
+    uniform_real_distribution<double_t> distribution(-1, 1);
+    mat_t m(n, p);
+
+    for (auto &value : m) {
+        value = distribution(generator);
+    }
+    return m;
+}
+
+static double_t maxDistance(const mat_t &m1, const mat_t &m2) {
+    double_t distance = 0;
+
+    EXPECT_EQ(m1.n(), m2.n());
+    EXPECT_EQ(m1.p(), m2.p());
+    for (size_t i = 0; i < m1.n(); ++i) {
+        for (size_t j = 0; j < m1.p(); ++j) {
+            distance = max(distance, abs(m1(i, j) - m2(i, j)));
+        }
+    }
+    return distance;
+}
+
+// Symmetric positive-definite matrix, strictly dominated by its diagonal
+static mat_t spd(size_t n, unsigned seed) {
+    mat_t a = random(n, n, seed), s = a.transposed() * a;
+
+    for (size_t i = 0; i < n; ++i) {
+        s(i, i) += n;
+    }
+    return s;
+}
+
+// Permutation matrix of the cycle sending each row to the next one, its determinant is (-1)^(n - 1)
+static mat_t cycle(size_t n) {
+    mat_t m = mat_t::zeros(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        m(i, (i + 1) % n) = 1;
+    }
+    return m;
+}
+
+TEST(NPMatrixTest, Det) {
+    mat_t swap{{0, 1, 0}, {1, 0, 0}, {0, 0, 1}}, cycle3{{0, 1, 0}, {0, 0, 1}, {1, 0, 0}};
+    mat_t singular{{1, 2}, {2, 4}};
+
+    EXPECT_EQ(swap.det(), -1);
+    EXPECT_EQ(cycle3.det(), 1);
+    EXPECT_EQ(singular.det(), 0);
+
+    // Pivots are exchanged across the panels of the blocked decomposition
+    for (size_t n : {NPMATRIX_LUP_NB - 1, NPMATRIX_LUP_NB, NPMATRIX_LUP_NB + 1}) {
+        mat_t m = cycle(n);
+
+        EXPECT_EQ(m.det(), n % 2 == 0 ? -1 : 1) << n;
+        m.swapRow(0, n - 1);
+        EXPECT_EQ(m.det(), n % 2 == 0 ? 1 : -1) << n;
+    }
+
+    mat_t m = random(100, 100, 1), swapped = m;
+    swapped.swapRow(3, 70);
+    EXPECT_NEAR(m.det(), -swapped.det(), 1e-9 * abs(m.det()));
+}
+
+TEST(NPMatrixTest, Solve) {
+    for (size_t n : {1, 2, 17, NPMATRIX_LUP_NB - 1, NPMATRIX_LUP_NB, NPMATRIX_LUP_NB + 1, 2 * NPMATRIX_LUP_NB + 1}) {
+        mat_t a = random(n, n, (unsigned) n), x = random(n, 3, (unsigned) n + 1);
+        vec_t u = x.col(0);
+
+        EXPECT_LT(!(a % (a * u) - u), 1e-9 * n) << n;
+        EXPECT_LT(maxDistance(a % (a * x), x), 1e-9 * n) << n;
+    }
+}
+
+TEST(NPMatrixTest, Cholesky) {
+    for (size_t n : {1, 2, 17, 100}) {
+        mat_t a = spd(n, (unsigned) n), l = a.cholL(), x = random(n, 3, 2);
+        vec_t u = x.col(0), b = a * u;
+
+        EXPECT_LT(maxDistance(l * l.transposed(), a), 1e-10 * n) << n;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                EXPECT_EQ(l(i, j), 0);
+            }
+        }
+
+        a.cholSolve(b);
+        EXPECT_LT(!(b - u), 1e-10 * n) << n;
+        mat_t bm = a * x;
+        a.cholSolve(bm);
+        EXPECT_LT(maxDistance(bm, x), 1e-10 * n) << n;
+    }
+
+    // The second member is left unchanged when the matrix isn't positive-definite
+    mat_t indefinite{{1, 2}, {2, 1}};
+    vec_t u{1, 1}, expect_u = u;
+
+    indefinite.cholSolve(u);
+    EXPECT_EQ(u, expect_u);
+}
+
+TEST(NPMatrixTest, QR) {
+    for (const auto &shape : vector<vector<size_t>>{{1, 1}, {10, 10}, {40, 10}, {100, 33}}) {
+        size_t n = shape[0], p = shape[1];
+        mat_t a = random(n, p, (unsigned) (n + p)), q = a.qrQ(), r = a.qrR();
+
+        EXPECT_LT(maxDistance(q * r, a), 1e-10 * n) << n;
+        EXPECT_LT(maxDistance(q.transposed() * q, mat_t::eye(p)), 1e-10 * n) << n;
+        for (size_t i = 0; i < p; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                EXPECT_EQ(r(i, j), 0);
+            }
+        }
+    }
+}
+
+TEST(NPMatrixTest, LeastSquares) {
+    mat_t a = random(40, 10, 3), at = a.transposed();
+    vec_t u = random(40, 1, 4).col(0), x = u;
+
+    // The residual of the least squares solution is orthogonal to the columns of A
+    a.qrSolve(x);
+    ASSERT_EQ(x.dim(), 10);
+    EXPECT_LT(!(at * (a * x - u)), 1e-10);
+    EXPECT_LT(!((at * a) % (at * u) - x), 1e-10);
+
+    // The second member is left unchanged when the columns of A are linearly dependent
+    mat_t deficient = a;
+    vec_t dependent = 2 * a.col(0) - a.col(5);
+    deficient.setCol(dependent, 9);
+    vec_t v = u;
+    deficient.qrSolve(v);
+    EXPECT_EQ(v, u);
+}
+
+TEST(NPMatrixTest, Transpose) {
+    for (size_t n : {1, 3, 8, 9, NBLAS_TRANSPOSE_NB - 1, NBLAS_TRANSPOSE_NB, NBLAS_TRANSPOSE_NB + 1, 100}) {
+        for (size_t p : {1, 4, 9, NBLAS_TRANSPOSE_NB, NBLAS_TRANSPOSE_NB + 1, 100}) {
+            mat_t m = random(n, p, (unsigned) (n * p)), expect_m = mat_t::zeros(p, n);
+
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < p; ++j) {
+                    expect_m(j, i) = m(i, j);
+                }
+            }
+            EXPECT_EQ(m.transposed(), expect_m) << n << " x " << p;
+
+            // In place, by blocks when square and following the cycles of the components otherwise
+            m.transpose();
+            EXPECT_EQ(m, expect_m) << n << " x " << p;
+        }
+    }
+
+    // Only the browsed square sub-matrix is transposed
+    for (size_t size : {5, NBLAS_TRANSPOSE_NB + 3}) {
+        mat_t m = random(size + 7, size + 4, 5), expect_m = m;
+
+        for (size_t i = 0; i < size; ++i) {
+            for (size_t j = 0; j < size; ++j) {
+                expect_m(i + 2, j + 3) = m(j + 2, i + 3);
+            }
+        }
+        m(2, 3, size + 1, size + 2).transpose();
+        EXPECT_EQ(m, expect_m) << size;
+    }
+}
+
+TEST(NPMatrixTest, View) {
+    const mat_t m = random(7, 9, 40);
+    const mat_t expect_sub = m(1, 2, 5, 7);
+    NMatrixView<double_t> v = m.view(1, 2, 5, 7), t = v.transposed();
+
+    ASSERT_EQ(v.n(), 5);
+    ASSERT_EQ(v.p(), 6);
+    ASSERT_EQ(t.n(), 6);
+    ASSERT_EQ(t.p(), 5);
+    for (size_t i = 0; i < v.n(); ++i) {
+        for (size_t j = 0; j < v.p(); ++j) {
+            EXPECT_EQ(v(i, j), m(i + 1, j + 2));
+            EXPECT_EQ(t(j, i), v(i, j));
+        }
+    }
+
+    // Rows of a row-major view are contiguous and its columns strided, the other way around once transposed
+    EXPECT_EQ(v.row(2).stride(), 1);
+    EXPECT_EQ(v.col(1).stride(), 9);
+    EXPECT_EQ(vec_t(v.row(2)), expect_sub.row(2));
+    EXPECT_EQ(vec_t(v.col(1)), expect_sub.col(1));
+    EXPECT_EQ(vec_t(t.row(1)), expect_sub.col(1));
+    EXPECT_EQ(vec_t(t.col(2)), expect_sub.row(2));
+    EXPECT_EQ(vec_t(v.row(2).view(1, 3)), vec_t({m(3, 3), m(3, 4), m(3, 5)}));
+    EXPECT_EQ(vec_t(v.row(0) + 2.0 * v.row(1)), expect_sub.row(0) + 2.0 * expect_sub.row(1));
+
+    // Views of views and copies whatever the layout
+    EXPECT_EQ(mat_t(v), expect_sub);
+    EXPECT_EQ(mat_t(t), expect_sub.transposed());
+    EXPECT_EQ(mat_t(v.view(1, 1, 3, 4)), m(2, 3, 4, 6));
+    EXPECT_EQ(mat_t(t.view(1, 1, 3, 4)), m(2, 3, 5, 5).transposed());
+    EXPECT_EQ(mat_t(t.transposed()), expect_sub);
+
+    // Column-major buffer of 3 x 4 components with a leading dimension of 5
+    vector<double_t> buffer(20);
+    for (size_t k = 0; k < buffer.size(); ++k) {
+        buffer[k] = k;
+    }
+    NMatrixView<double_t> c(buffer.data(), 3, 4, 5, ColMajor);
+    EXPECT_EQ(mat_t(c), mat_t({{0, 5, 10, 15}, {1, 6, 11, 16}, {2, 7, 12, 17}}));
+    EXPECT_EQ(mat_t(c.transposed()), mat_t({{0, 5, 10, 15}, {1, 6, 11, 16}, {2, 7, 12, 17}}).transposed());
+}
+
+TEST(NPMatrixTest, ViewAliases) {
+    vec_t u = vec_t::zeros(10);
+    const mat_t m = random(4, 4, 41);
+    NVectorView<double_t> w = u.view(2, 5);
+
+    // The same contiguous components are read in the order they are written
+    EXPECT_FALSE(w.aliases(u.data() + 2, 4));
+    EXPECT_TRUE(w.aliases(u.data() + 3, 4));
+    EXPECT_TRUE(w.aliases(u.data(), 3));
+    EXPECT_FALSE(w.aliases(u.data(), 2));
+    EXPECT_FALSE(w.aliases(u.data() + 6, 4));
+
+    // A column reads the components of the rows it writes in another order
+    EXPECT_TRUE(m.view().col(0).aliases(m.data(), 4));
+    EXPECT_TRUE(m.view().col(1).aliases(m.data() + 12, 4));
+    EXPECT_FALSE(m.view().col(1).aliases(m.data() + 14, 2));
+    EXPECT_FALSE(NVectorView<double_t>(u.data(), 0).aliases(u.data(), 10));
+}
+
+TEST(NPMatrixTest, ViewProduct) {
+    const mat_t a = random(40, 50, 42), b = random(60, 30, 43);
+    const vec_t x = random(1, 40, 44).row(0);
+    NMatrixView<double_t> va = a.view(2, 3, 31, 42), vb = b.view(5, 1, 44, 20);
+    mat_t sa = a(2, 3, 31, 42), sb = b(5, 1, 44, 20), expect_ab = sa * sb;
+
+    EXPECT_LT(maxDistance(NPMatrix<double_t>::product(va, vb), expect_ab), 1e-12);
+    EXPECT_LT(maxDistance(va * vb, expect_ab), 1e-12);
+    EXPECT_LT(maxDistance(vb.transposed() * va.transposed(), expect_ab.transposed()), 1e-12);
+    EXPECT_LT(maxDistance(mat_t(va.transposed()).transposed() * sb, expect_ab), 1e-12);
+
+    // Linear maps with contiguous and strided vectors, on both layouts
+    const vec_t col = a.col(7);
+    EXPECT_LT(!(va * x.view(0, 39) - sa * vec_t(x)), 1e-12);
+    EXPECT_LT(!(va.transposed() * a.view().col(7).view(2, 31) - sa.transposed() * col(2, 31)), 1e-12);
+    EXPECT_LT(!(va * b.view().col(3).view(0, 39) - sa * b.col(3)(0, 39)), 1e-12);
+}
+
+TEST(NPMatrixTest, ViewThreads) {
+    const mat_t m = random(64, 48, 45);
+    vector<mat_t> expect_sub;
+    vector<thread> threads;
+    vector<size_t> errors(4, 0);
+
+    for (size_t i = 0; i < 8; ++i) {
+        expect_sub.push_back(m(i, 2 * i, i + 40, 2 * i + 30));
+    }
+
+    // Views and sub-matrices of the same const matrix are taken at the same time, the matrix is never written
+    for (size_t t = 0; t < errors.size(); ++t) {
+        threads.emplace_back([&m, &expect_sub, &errors, t]() {
+            for (size_t r = 0; r < 200; ++r) {
+                size_t i = (r + t) % expect_sub.size();
+                NMatrixView<double_t> v = m.view(i, 2 * i, i + 40, 2 * i + 30);
+
+                errors[t] += mat_t(v) != expect_sub[i];
+                errors[t] += m(i, 2 * i, i + 40, 2 * i + 30) != expect_sub[i];
+                errors[t] += vec_t(v.col(3)) != expect_sub[i].col(3);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(errors, vector<size_t>(errors.size(), 0));
+}
@@ -0,0 +1,118 @@
+//
+// Created by Sami Dahoux on 2019-02-05.
+//
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <NVector.h>
+
+using namespace std;
+
+// Storage of the components 0, 1, ..., size - 1
+static NStorage<double_t> range(size_t size) {
+    NStorage<double_t> s(size);
+
+    iota(s.begin(), s.end(), 0);
+    return s;
+}
+
+TEST(NStorageTest, Inline) {
+    NStorage<double_t> s = range(NSTORAGE_INLINE);
+
+    EXPECT_TRUE(s.isInline());
+    EXPECT_EQ(s.capacity(), NSTORAGE_INLINE);
+
+    // The components are copied to the heap when the storage grows past its inline capacity
+    s.push_back(NSTORAGE_INLINE);
+    EXPECT_FALSE(s.isInline());
+    EXPECT_EQ(s, range(NSTORAGE_INLINE + 1));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(s.data()) % NALLOCATOR_ALIGNMENT, 0);
+
+    // Allocated arrays are kept when the storage shrinks
+    s.pop_back();
+    EXPECT_FALSE(s.isInline());
+    EXPECT_EQ(s, range(NSTORAGE_INLINE));
+
+    NStorage<double_t> t(NSTORAGE_INLINE + 1, 2.0);
+    EXPECT_FALSE(t.isInline());
+    t.resize(3);
+    t.resize(5, 1.0);
+    EXPECT_EQ(t, (NStorage<double_t>{2, 2, 2, 1, 1}));
+    EXPECT_THROW(t.at(5), out_of_range);
+}
+
+TEST(NStorageTest, Move) {
+    for (size_t size : {0, 1, NSTORAGE_INLINE, NSTORAGE_INLINE + 1, 100}) {
+        NStorage<double_t> s = range(size), copy = s;
+        const double_t *data = s.data();
+
+        // Allocated arrays are taken, inline components are copied
+        NStorage<double_t> moved(std::move(s));
+        EXPECT_EQ(moved, range(size)) << size;
+        EXPECT_EQ(moved.data() == data, size > NSTORAGE_INLINE) << size;
+
+        // The moved-from storage is empty, inline, and can be used again
+        EXPECT_TRUE(s.empty()) << size;
+        EXPECT_TRUE(s.isInline()) << size;
+        s.push_back(1);
+        EXPECT_EQ(s, NStorage<double_t>{1});
+
+        // Move assignment releases the array of the destination, whatever the size of both
+        for (size_t other : {1, NSTORAGE_INLINE + 1}) {
+            NStorage<double_t> assigned = range(other), source = copy;
+
+            assigned = std::move(source);
+            EXPECT_EQ(assigned, range(size)) << size << " <- " << other;
+            EXPECT_TRUE(source.empty());
+        }
+
+        NStorage<double_t> &self = copy;
+        copy = std::move(self);
+        EXPECT_EQ(copy, range(size)) << size;
+    }
+}
+
+TEST(NStorageTest, InsertErase) {
+    for (size_t size : {3, NSTORAGE_INLINE - 1, NSTORAGE_INLINE, 20}) {
+        NStorage<double_t> s = range(size), expect_s;
+
+        // Inserting the storage into itself reads the components before moving them
+        s.insert(s.begin() + 1, s.begin(), s.end());
+        expect_s.push_back(0);
+        for (size_t k = 0; k < size; ++k) {
+            expect_s.push_back(k);
+        }
+        for (size_t k = 1; k < size; ++k) {
+            expect_s.push_back(k);
+        }
+        EXPECT_EQ(s, expect_s) << size;
+
+        s.insert(s.begin(), s.back());
+        EXPECT_EQ(s.front(), size - 1) << size;
+        EXPECT_EQ(s.size(), 2 * size + 1);
+
+        s.erase(s.begin(), s.begin() + size + 2);
+        NStorage<double_t> expect_tail = range(size);
+        expect_tail.erase(expect_tail.begin());
+        EXPECT_EQ(s, expect_tail) << size;
+        s.erase(s.begin());
+        EXPECT_EQ(s.size(), size - 2);
+    }
+}
+
+TEST(NStorageTest, Release) {
+    for (size_t size : {NSTORAGE_INLINE, NSTORAGE_INLINE + 1, 20}) {
+        NStorage<double_t> components = range(size);
+        vec_t u(range(size));
+
+        // Only the browsed components are taken, the moved-from vector is empty
+        vec_t moved{std::move(u(2, size - 1))};
+        EXPECT_EQ(moved, vec_t(NStorage<double_t>(components.begin() + 2, components.end()))) << size;
+        EXPECT_EQ(u.size(), 0) << size;
+
+        u = vec_t::ones(size);
+        moved = std::move(u(1, 3));
+        EXPECT_EQ(moved, vec_t::ones(3)) << size;
+        EXPECT_EQ(moved.isInline(), size <= NSTORAGE_INLINE) << size;
+    }
+}
@@ -0,0 +1,129 @@
+//
+// Created by Sami Dahoux on 2019-02-05.
+//
+
+#include <gtest/gtest.h>
+#include <NVector.h>
+
+using namespace std;
+
+TEST(NVectorTest, Expression) {
+    vec_t u{1, 2, 3, 4}, v{-1, 0.5, 2, 8}, w{3, 3, 3, 3};
+    vec_t expect_fused{1 + 2 * -1 - 1.5, 2 + 2 * 0.5 - 1.5, 3 + 2 * 2 - 1.5, 4 + 2 * 8 - 1.5};
+
+    // Chains are computed in a single loop, the same way as the components
+    vec_t fused = u + 2.0 * v - w / 2.0;
+    EXPECT_EQ(fused, expect_fused);
+    EXPECT_EQ(vec_t(-(u - v) * 2.0), vec_t({-4, -3, -2, 8}));
+    EXPECT_EQ((u + v) | w, (u | w) + (v | w));
+    EXPECT_DOUBLE_EQ(!(u - v), u / v);
+    EXPECT_DOUBLE_EQ(u / (v + w), !(u - v - w));
+
+    // Browsed leaves take their range when the expression is built and reset the browse indices
+    vec_t sub = u(0, 1) + v(2, 3);
+    EXPECT_EQ(sub, vec_t({3, 10}));
+    EXPECT_EQ(u.dim(), 4);
+    EXPECT_EQ(v.dim(), 4);
+
+    // Only the browsed components of the destination are written
+    vec_t x = u;
+    x(1, 2) = v(0, 1) + w(2, 3);
+    EXPECT_EQ(x, vec_t({1, 2, 3.5, 4}));
+}
+
+TEST(NVectorTest, ExpressionAliasing) {
+    vec_t u{1, 2, 3, 4, 5}, v{10, 20, 30};
+
+    // The operands overlap the result with a shift, they are computed aside
+    u = u(1, 3) + v;
+    EXPECT_EQ(u, vec_t({12, 23, 34}));
+
+    vec_t x{1, 2, 3, 4, 5};
+    x = 2.0 * x(1, 4) - vec_t::ones(4);
+    EXPECT_EQ(x, vec_t({3, 5, 7, 9}));
+
+    // Reading and writing the same components is safe
+    vec_t y{1, 2, 3};
+    y = y + y * 2.0;
+    EXPECT_EQ(y, vec_t({3, 6, 9}));
+}
+
+TEST(NVectorTest, ExpressionUpdate) {
+    vec_t u{1, 2, 3}, v{1, 1, 1}, w{2, 4, 6};
+
+    u += v + w / 2.0;
+    EXPECT_EQ(u, vec_t({3, 5, 7}));
+    u -= 2.0 * v - w;
+    EXPECT_EQ(u, vec_t({3, 7, 11}));
+
+    u(0, 1) += v(1, 2) + w(0, 1);
+    EXPECT_EQ(u, vec_t({6, 12, 11}));
+    EXPECT_EQ(u.dim(), 3);
+}
+
+TEST(NVectorTest, ExpressionMethods) {
+    vec_t u{1, -5, 3}, v{2, 2, 2};
+
+    // Read-only methods of vectors are computed on the vector of the expression
+    EXPECT_EQ((u + v).max(), 5);
+    EXPECT_EQ((u + v).min(), -3);
+    EXPECT_EQ((u + v).maxAbsIndex(), 2);
+    EXPECT_EQ((u - v).minmax(), make_pair(-7.0, 1.0));
+    EXPECT_EQ((u + v).sum(), 5);
+    EXPECT_DOUBLE_EQ((u + v).norm(), !vec_t(u + v));
+    EXPECT_EQ((u + v)(1), -3);
+    EXPECT_EQ((u + v)(0, 1), vec_t({3, -3}));
+    EXPECT_EQ((u + v).array(), vector<double_t>({3, -3, 5}));
+    EXPECT_EQ((u + v).str(), vec_t(u + v).str());
+    EXPECT_EQ((u + v).eval().shift(1), vec_t({-3, 5, 3}));
+}
+
+TEST(NVectorTest, ExpressionTemporary) {
+    vec_t u{1, 2, 3};
+
+    // Temporary vectors are moved into the expression, which can be stored
+    auto e = u + vec_t{10, 20, 30};
+    auto f = 2.0 * (vec_t{1, 1, 1} - e);
+    vec_t heap = vec_t::ones(20) * 3.0;
+    auto g = vec_t::ones(10) + heap(5, 14) * 2.0;
+
+    EXPECT_EQ(vec_t(e), vec_t({11, 22, 33}));
+    EXPECT_EQ(vec_t(f), vec_t({-20, -42, -64}));
+    EXPECT_EQ(vec_t(g), vec_t::ones(10) * 7.0);
+}
+
+TEST(NVectorTest, MinAbs) {
+    vec_t u{-5, 2, -1, 3, 1, -5};
+
+    // The smallest absolute value is not always the one of the minimum or of the maximum
+    EXPECT_EQ(u.minAbs(), 1);
+    EXPECT_EQ(u.minAbsIndex(), 2);
+    EXPECT_EQ(u.maxAbs(), 5);
+    EXPECT_EQ(u.maxAbsIndex(), 0);
+    EXPECT_EQ(u.minmaxAbsIndex(), make_pair((size_t) 2, (size_t) 0));
+    EXPECT_EQ(u.minmaxIndex(), make_pair((size_t) 0, (size_t) 3));
+    EXPECT_EQ(u.minmax(), make_pair(-5.0, 3.0));
+    EXPECT_EQ(u.sum(), -5);
+
+    // Browsed components only
+    EXPECT_EQ(u(3, 5).minAbs(), 1);
+    EXPECT_EQ(u(3, 5).minAbsIndex(), 1);
+}
+
+TEST(NVectorTest, SumProd) {
+    vector<vec_t> vectors{{1, 2, 3, 4, 5}, {0, 1, 0, 1, 0}, {2, 2, 2, 2, 2}, {1, 0, 0, 0, 0}, {0, 0, 0, 0, 9}};
+
+    EXPECT_EQ(vec_t::sumProd({1, 1, 1, 1, 1}, vectors), vec_t::sum(vectors));
+    EXPECT_EQ(vec_t::sumProd({1, 2, 1, 3, 1}, vectors), vec_t({6, 6, 5, 8, 16}));
+
+    // Browsed vectors are combined on their browsed components, then browse all their components again
+    vectors[0](1, 3);
+    vectors[3](1, 3);
+    for (size_t k : {1, 2, 4}) {
+        vectors[k](2, 4);
+    }
+    EXPECT_EQ(vec_t::sumProd({1, 2, 1, 3, 1}, vectors), vec_t({4, 7, 15}));
+    for (const auto &u : vectors) {
+        EXPECT_EQ(u.end() - u.begin(), 5);
+    }
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <PHaar.h>
+#include <IBand.h>
 
 class PHaarTest : public ::testing::Test {
 public:
@@ -20,3 +21,28 @@ TEST_F(PHaarTest, FunctionOp) {
 
 
 
+TEST_F(PHaarTest, Lanes) {
+    IMatrix img{mat_pix_t::zeros(40, 90)};
+    int32_t sums[P_HAAR_LANES];
+
+    for (size_t x = 0; x < img.width(); ++x) {
+        for (size_t y = 0; y < img.height(); ++y) {
+            img(x, y) = Pixel((int) ((11 * x + 5 * y + (x * y) % 7) % 256));
+        }
+    }
+    IBand band{img};
+
+    for (auto type : {PHaar::TwoRectW, PHaar::TwoRectH, PHaar::ThreeRect, PHaar::FourRect}) {
+        for (size_t stride : {1, 3}) {
+            PHaar g = PHaar(2, 1, 12, 6, type).placed(5, 4, 2);
+            uint32_t mask = (1u << P_HAAR_LANES) - 1 - 2;
+
+            g.lanes(band, stride, mask, sums);
+            for (size_t k = 0; k < P_HAAR_LANES; ++k) {
+                PHaar gk = PHaar(g).move(0, k * stride);
+                EXPECT_EQ(sums[k] / 3, k == 1 ? 0 : gk(img));
+                EXPECT_EQ(sums[k] / 3, k == 1 ? 0 : gk(band));
+            }
+        }
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Created by Sami Dahoux on 2019-02-05.
+//
+
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <Vector3Batch.h>
+
+using namespace std;
+
+static Vector3Batch random(size_t size, unsigned seed) {
+    mt19937 generator(seed);
+    uniform_real_distribution<double_t> distribution(-2, 2);
+    Vector3Batch u(size);
+
+    for (size_t k = 0; k < size; ++k) {
+        u.set(k, Vector3(distribution(generator), distribution(generator), distribution(generator)));
+    }
+    return u;
+}
+
+static void expectNear(const Vector3Batch &u, const vector<Vector3> &expected) {
+    ASSERT_EQ(u.size(), expected.size());
+    for (size_t k = 0; k < u.size(); ++k) {
+        EXPECT_NEAR(u[k] / expected[k], 0, 1e-14) << k;
+    }
+}
+
+// Sizes around the 4 vectors of the lanes, the last ones are computed one by one
+TEST(Vector3BatchTest, Operations) {
+    const Matrix3 m(1, -2, 0.5, 3, 0, -1, 0.25, 2, 1);
+
+    for (size_t size : {1, 3, 4, 5, 7, 8, 13}) {
+        Vector3Batch u = random(size, 1), v = random(size, 2);
+        vector<Vector3> us = u.vectors(), vs = v.vectors(), expect_cross, expect_scale, expect_apply, expect_prod;
+        vec_t s = random(size, 3).r(), dot = u | v, norm = !u;
+
+        for (size_t k = 0; k < size; ++k) {
+            EXPECT_NEAR(dot(k), us[k] | vs[k], 1e-14) << size;
+            EXPECT_NEAR(norm(k), !us[k], 1e-14) << size;
+            expect_cross.push_back(us[k] ^ vs[k]);
+            expect_scale.push_back(-1.5 * us[k]);
+            expect_prod.push_back(s(k) * us[k]);
+            expect_apply.push_back(m * us[k]);
+        }
+        expectNear(u ^ v, expect_cross);
+        expectNear(-1.5 * u, expect_scale);
+        expectNear(m * u, expect_apply);
+
+        // The result can be written over an operand
+        Vector3Batch r = u;
+        Vector3Batch::scale(r, s.data(), r);
+        expectNear(r, expect_prod);
+        r = u;
+        Vector3Batch::cross(r, v, r);
+        expectNear(r, expect_cross);
+        r = v;
+        Vector3Batch::cross(u, r, r);
+        expectNear(r, expect_cross);
+        r = u;
+        Vector3Batch::apply(m, r, r);
+        expectNear(r, expect_apply);
+        vec_t norm_v = !v;
+        Vector3Batch::dot(u, v, u.x());
+        Vector3Batch::norm(v, v.y());
+        for (size_t k = 0; k < size; ++k) {
+            EXPECT_EQ(u.x()[k], dot(k)) << size;
+            EXPECT_EQ(v.y()[k], norm_v(k)) << size;
+        }
+    }
+}
+
+TEST(Vector3BatchTest, Str) {
+    Vector3Batch u{Vector3(1, 0, 0), Vector3(0, 1, 0)}, v = Vector3Batch::ones(2);
+    stringstream stream;
+
+    stream << (u | v);
+    EXPECT_EQ(stream.str(), "( 1 1 )");
+}
+
+TEST(Vector3BatchTest, Angles) {
+    Vector3Batch u{Vector3(1, 0, 0), Vector3(0, 2, 2), Vector3(-1, -1, -3), Vector3(3, 4, 0), Vector3(0, 0, -1)};
+    vector<Vector3> vectors = u.vectors();
+    vec_t theta = u.theta(), phi = u.phi();
+
+    for (size_t k = 0; k < u.size(); ++k) {
+        EXPECT_DOUBLE_EQ(theta(k), vectors[k].theta()) << k;
+        EXPECT_DOUBLE_EQ(phi(k), vectors[k].phi()) << k;
+    }
+
+    // The angles can be written over the components of the batch
+    Vector3Batch::phi(u, u.z());
+    Vector3Batch::theta(u, u.x());
+    for (size_t k = 0; k < u.size(); ++k) {
+        EXPECT_DOUBLE_EQ(u.z()[k], vectors[k].phi()) << k;
+        EXPECT_DOUBLE_EQ(u.x()[k], vectors[k].theta()) << k;
+    }
+}